@@ -1,12 +1,15 @@
 // Minimal driver: orchestrates the refactored modules only
 #include <iostream>
 #include <algorithm>
+#include <charconv>
 #include "nlohmann/json.hpp"
 #include "utils.h"
 #include "config_manager.h"
 #include "map_generator.h"
 #include "stands.h"
+#include "stand_table.h"
 #include "live_reload.h"
+#include "render_scheduler.h"
 
 constexpr auto version = "v1.1.1";
 
@@ -35,7 +38,7 @@ static void printBanner()
     std::cout << CYAN << banner << BOLD << "version: " << version << RESET << std::endl;
 }
 
-static int initConfig(nlohmann::ordered_json &configJson, bool &mapGenerated, std::string &icao)
+static int initConfig(nlohmann::ordered_json &configJson, StandTable &stands, bool &mapGenerated, std::string &icao)
 {
     mapGenerated = false;
     printBanner();
@@ -49,20 +52,95 @@ static int initConfig(nlohmann::ordered_json &configJson, bool &mapGenerated, st
         std::transform(icao.begin(), icao.end(), icao.begin(), ::toupper);
         break;
     }
-    if (!getConfig(icao, configJson, mapGenerated))
+    if (!getConfig(icao, configJson, stands, mapGenerated))
         return 1;
     std::cout << "JSON edition ready." << std::endl;
     printMenu();
     return 0;
 }
 
+static void setMapDebounce(RenderScheduler &mapRenderer, const std::string &value)
+{
+    std::string text = value;
+    text.erase(0, text.find_first_not_of(' '));
+    if (text.empty())
+    {
+        std::cout << "Map debounce: " << mapRenderer.debounce().count() << " ms" << std::endl;
+        return;
+    }
+    // Whole milliseconds only, anything left after the digits is rejected
+    long long milliseconds = -1;
+    auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), milliseconds);
+    if (error != std::errc() || end != text.data() + text.size() || milliseconds < 0 || milliseconds > 60000)
+    {
+        std::cout << RED << "Invalid debounce. Please give a delay in milliseconds (0 to 60000)." << RESET << std::endl;
+        return;
+    }
+    mapRenderer.setDebounce(std::chrono::milliseconds(milliseconds));
+    std::cout << "Map debounce set to " << mapRenderer.debounce().count() << " ms." << std::endl;
+}
+
+static void setMapFiles(RenderScheduler &mapRenderer, const StandTable &stands, const std::string &icao, bool mapGenerated, const std::string &value)
+{
+    std::string text = value;
+    text.erase(0, text.find_first_not_of(' '));
+    if (text.empty())
+    {
+        std::cout << "Map files: " << (mapFilesWritten() ? "on" : "off") << std::endl;
+        return;
+    }
+    if (text != "on" && text != "off")
+    {
+        std::cout << RED << "Invalid value. Please use map files on or map files off." << RESET << std::endl;
+        return;
+    }
+    setMapFilesWritten(text == "on");
+    std::cout << "Map files " << (mapFilesWritten() ? "on: the map is written to disk as well." : "off: the map is only served by the live reload server.") << std::endl;
+    // Brings the files on disk up to date right away
+    if (mapGenerated && mapFilesWritten())
+        mapRenderer.renderNow(stands, icao, false);
+}
+
+static void setMapRenderer(RenderScheduler &mapRenderer, const StandTable &stands, const std::string &icao, bool mapGenerated, const std::string &value)
+{
+    std::string text = value;
+    text.erase(0, text.find_first_not_of(' '));
+    if (text.empty())
+    {
+        std::cout << "Map renderer: " << standRendererName(mapStandRenderer()) << std::endl;
+        return;
+    }
+    StandRenderer renderer;
+    if (text == "auto")
+        renderer = StandRenderer::Auto;
+    else if (text == "svg")
+        renderer = StandRenderer::Svg;
+    else if (text == "canvas")
+        renderer = StandRenderer::Canvas;
+    else
+    {
+        std::cout << RED << "Invalid renderer. Please use auto, svg or canvas." << RESET << std::endl;
+        return;
+    }
+    setMapStandRenderer(renderer);
+    std::cout << "Map renderer set to " << standRendererName(renderer) << "." << std::endl;
+    if (mapGenerated)
+    {
+        mapRenderer.renderNow(stands, icao, false);
+        std::cout << "Reload the open map pages to switch them over." << std::endl;
+    }
+}
+
 int main()
 {
     bool mapGenerated = false;
     nlohmann::ordered_json configJson;
+    StandTable stands;
     std::string icao;
+    // Map rewrites after edits happen in the background, coalesced over the debounce window
+    RenderScheduler mapRenderer;
 
-    if (initConfig(configJson, mapGenerated, icao) != 0)
+    if (initConfig(configJson, stands, mapGenerated, icao) != 0)
         return 1;
 
     std::string command;
@@ -80,77 +158,112 @@ int main()
         }
         if (cmdLower == "save")
         {
-            saveFile(icao, configJson);
+            saveFile(icao, configJson, stands);
             if (mapGenerated)
-                generateMap(configJson, icao, false);
+                mapRenderer.markDirty(stands, icao);
             continue;
         }
         if (cmdLower == "list")
         {
-            listAllStands(configJson);
+            listAllStands(stands);
+            continue;
+        }
+        if (cmdLower == "overlaps" || cmdLower == "overlaps export")
+        {
+            listOverlaps(stands, icao, cmdLower == "overlaps export");
             continue;
         }
         if (cmdLower == "map")
         {
-            generateMap(configJson, icao, true);
+            mapRenderer.renderNow(stands, icao, true);
             mapGenerated = true;
             continue;
         }
+        if (cmdLower.rfind("map debounce", 0) == 0)
+        {
+            setMapDebounce(mapRenderer, command.substr(12));
+            continue;
+        }
+        if (cmdLower.rfind("map files", 0) == 0)
+        {
+            setMapFiles(mapRenderer, stands, icao, mapGenerated, cmdLower.substr(9));
+            continue;
+        }
+        if (cmdLower.rfind("map renderer", 0) == 0)
+        {
+            setMapRenderer(mapRenderer, stands, icao, mapGenerated, cmdLower.substr(12));
+            continue;
+        }
 
         // commands with args
+        if (cmdLower.rfind("filter ", 0) == 0)
+        {
+            filterStands(stands, command.substr(7));
+            continue;
+        }
+        if (cmdLower.rfind("nearest ", 0) == 0)
+        {
+            nearestStands(stands, command.substr(8));
+            continue;
+        }
+        if (cmdLower.rfind("within ", 0) == 0)
+        {
+            standsWithin(stands, command.substr(7));
+            continue;
+        }
         if (cmdLower.rfind("add ", 0) == 0)
         {
-            addStand(configJson, command.substr(4));
+            addStand(stands, command.substr(4));
             if (mapGenerated)
-                generateMap(configJson, icao, false);
+                mapRenderer.markDirty(stands, icao);
             continue;
         }
         if (cmdLower.rfind("remove ", 0) == 0)
         {
-            removeStand(configJson, command.substr(7));
+            removeStand(stands, command.substr(7));
             if (mapGenerated)
-                generateMap(configJson, icao, false);
+                mapRenderer.markDirty(stands, icao);
             continue;
         }
         if (cmdLower.rfind("copy ", 0) == 0)
         {
-            copyStand(configJson, command.substr(5));
+            copyStand(stands, command.substr(5));
             if (mapGenerated)
-                generateMap(configJson, icao, false);
+                mapRenderer.markDirty(stands, icao);
             continue;
         }
         if (cmdLower.rfind("batchcopy ", 0) == 0)
         {
-            batchcopy(configJson, command.substr(10));
+            batchcopy(stands, command.substr(10));
             if (mapGenerated)
-                generateMap(configJson, icao, false);
+                mapRenderer.markDirty(stands, icao);
             continue;
         }
         if (cmdLower.rfind("softcopy ", 0) == 0)
         {
-            softStandCopy(configJson, command.substr(9));
+            softStandCopy(stands, command.substr(9));
             if (mapGenerated)
-                generateMap(configJson, icao, false);
+                mapRenderer.markDirty(stands, icao);
             continue;
         }
         if (cmdLower.rfind("edit ", 0) == 0)
         {
-            editStand(configJson, command.substr(5));
+            editStand(stands, command.substr(5));
             if (mapGenerated)
-                generateMap(configJson, icao, false);
+                mapRenderer.markDirty(stands, icao);
             continue;
         }
         if (cmdLower.rfind("radius ", 0) == 0)
         {
-            editStandRadius(configJson, command.substr(7));
+            editStandRadius(stands, command.substr(7));
             if (mapGenerated)
-                generateMap(configJson, icao, false);
+                mapRenderer.markDirty(stands, icao);
             continue;
         }
 
         if (cmdLower == "config")
         {
-            if (initConfig(configJson, mapGenerated, icao) != 0)
+            if (initConfig(configJson, stands, mapGenerated, icao) != 0)
                 return 1;
             continue;
         }
@@ -161,79 +274,79 @@ int main()
         }
         if (cmdLower.rfind("apron ", 0) == 0)
         {
-            editApron(configJson, command.substr(6));
+            editApron(stands, command.substr(6));
             if (mapGenerated)
-                generateMap(configJson, icao, false);
+                mapRenderer.markDirty(stands, icao);
             continue;
         }
         if (cmdLower.rfind("priority ", 0) == 0)
         {
-            editPriority(configJson, command.substr(9));
+            editPriority(stands, command.substr(9));
             if (mapGenerated)
-                generateMap(configJson, icao, false);
+                mapRenderer.markDirty(stands, icao);
             continue;
         }
         if (cmdLower.rfind("wingspan ", 0) == 0)
         {
-            editWingspan(configJson, command.substr(9));
+            editWingspan(stands, command.substr(9));
             if (mapGenerated)
-                generateMap(configJson, icao, false);
+                mapRenderer.markDirty(stands, icao);
             continue;
         }
         if (cmdLower.rfind("remark ", 0) == 0)
         {
-            editRemark(configJson, command.substr(7));
+            editRemark(stands, command.substr(7));
             if (mapGenerated)
-                generateMap(configJson, icao, false);
+                mapRenderer.markDirty(stands, icao);
             continue;
         }
         if (cmdLower.rfind("code ", 0) == 0)
         {
-            editCode(configJson, command.substr(5));
+            editCode(stands, command.substr(5));
             if (mapGenerated)
-                generateMap(configJson, icao, false);
+                mapRenderer.markDirty(stands, icao);
             continue;
         }
         if (cmdLower.rfind("use ", 0) == 0)
         {
-            editUse(configJson, command.substr(4));
+            editUse(stands, command.substr(4));
             if (mapGenerated)
-                generateMap(configJson, icao, false);
+                mapRenderer.markDirty(stands, icao);
             continue;
         }
         if (cmdLower.rfind("schengen ", 0) == 0)
         {
-            editSchengen(configJson, command.substr(9));
+            editSchengen(stands, command.substr(9));
             if (mapGenerated)
-                generateMap(configJson, icao, false);
+                mapRenderer.markDirty(stands, icao);
             continue;
         }
         if (cmdLower.rfind("callsigns ", 0) == 0)
         {
-            editCallsigns(configJson, command.substr(10));
+            editCallsigns(stands, command.substr(10));
             if (mapGenerated)
-                generateMap(configJson, icao, false);
+                mapRenderer.markDirty(stands, icao);
             continue;
         }
         if (cmdLower.rfind("countries ", 0) == 0)
         {
-            editCountries(configJson, command.substr(10));
+            editCountries(stands, command.substr(10));
             if (mapGenerated)
-                generateMap(configJson, icao, false);
+                mapRenderer.markDirty(stands, icao);
             continue;
         }
         if (cmdLower.rfind("block ", 0) == 0)
         {
-            editBlock(configJson, command.substr(6));
+            editBlock(stands, command.substr(6));
             if (mapGenerated)
-                generateMap(configJson, icao, false);
+                mapRenderer.markDirty(stands, icao);
             continue;
         }
         if (cmdLower.rfind("rename ", 0) == 0)
         {
-            renameStand(configJson, command.substr(7));
+            renameStand(stands, command.substr(7));
             if (mapGenerated)
-                generateMap(configJson, icao, false);
+                mapRenderer.markDirty(stands, icao);
             continue;
         }
 
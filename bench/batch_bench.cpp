@@ -0,0 +1,92 @@
+// Parses a pasted batchcopy block line by line (stringstream split, then
+// parseCoordinateText per line) against parseCoordinateBatch on the whole buffer.
+// Build and run with: make bench && ./bench/batch_bench
+#include "coordinate_batch.h"
+#include "utils.h"
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    // name:lat:lon:radius lines around Nice, one in twenty malformed or out of range
+    std::string makeBlock(size_t count)
+    {
+        std::mt19937 rng(5);
+        std::uniform_real_distribution<double> lat(43.60, 43.70);
+        std::uniform_real_distribution<double> lon(7.18, 7.25);
+        std::string block;
+        char buffer[96];
+        for (size_t i = 0; i < count; i++)
+        {
+            int radius = 15 + static_cast<int>(rng() % 30);
+            if (i % 20 == 7)
+                std::snprintf(buffer, sizeof(buffer), "B%zu:%.6f:%.6f:%d\n", i, 93.5, lon(rng), radius);
+            else if (i % 20 == 13)
+                std::snprintf(buffer, sizeof(buffer), "B%zu:%.6f;%.6f:%d\n", i, lat(rng), lon(rng), radius);
+            else
+                std::snprintf(buffer, sizeof(buffer), "B%zu:%.6f:%.6f:%d\n", i, lat(rng), lon(rng), radius);
+            block += buffer;
+        }
+        return block;
+    }
+
+    template <typename F>
+    double timeMs(F &&f)
+    {
+        auto start = std::chrono::steady_clock::now();
+        f();
+        auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    }
+
+    void run(size_t count)
+    {
+        const std::string block = makeBlock(count);
+
+        size_t perLineValid = 0;
+        double perLineMs = timeMs([&]
+                                  {
+            std::istringstream lines(block);
+            std::string line;
+            while (std::getline(lines, line))
+            {
+                std::vector<std::string> parts;
+                std::istringstream stream(line);
+                std::string part;
+                while (std::getline(stream, part, ':'))
+                    parts.push_back(part);
+                if (parts.size() != 4)
+                    continue;
+                CoordinateParse parse = parseCoordinateText(parts[1] + ":" + parts[2] + ":" + parts[3]);
+                if (parse.ok)
+                    perLineValid++;
+            } });
+
+        size_t batchValid = 0;
+        double batchMs = timeMs([&]
+                                {
+            CoordinateBatch batch = parseCoordinateBatch(block);
+            for (BatchError error : batch.errors)
+            {
+                if (error == BatchError::None)
+                    batchValid++;
+            } });
+
+        std::cout << count << " lines (" << block.size() / 1024 << " KiB)" << std::endl;
+        std::cout << "  per line:        " << perLineMs << " ms" << std::endl;
+        std::cout << "  batch:           " << batchMs << " ms" << std::endl;
+        std::cout << "  valid lines:     " << perLineValid << " / " << batchValid << std::endl;
+    }
+}
+
+int main()
+{
+    run(1000);
+    run(100000);
+    return 0;
+}
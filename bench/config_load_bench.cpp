@@ -0,0 +1,95 @@
+// Loads a synthetic 20k-stand config through getConfig, once parsed from the JSON and once
+// from the .cfgcache snapshot, with a few stands the save has to write back as read.
+// Build and run with: make bench && ./bench/config_load_bench
+#include "config_manager.h"
+#include "stand_table.h"
+#include "utils.h"
+#include "nlohmann/json.hpp"
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+
+namespace
+{
+    template <typename F>
+    double timeMs(F &&f)
+    {
+        auto start = std::chrono::steady_clock::now();
+        f();
+        auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    }
+
+    // getConfig reports every step, the bench only wants the timings
+    double loadMs(const std::string &icao, StandTable &stands)
+    {
+        std::ostringstream quiet;
+        std::streambuf *out = std::cout.rdbuf(quiet.rdbuf());
+        nlohmann::ordered_json configJson;
+        bool mapGenerated = false;
+        double ms = timeMs([&]
+                           { getConfig(icao, configJson, stands, mapGenerated); });
+        std::cout.rdbuf(out);
+        return ms;
+    }
+
+    void run(size_t count)
+    {
+        std::mt19937 rng(7);
+        std::uniform_real_distribution<double> lat(43.645, 43.681);
+        std::uniform_real_distribution<double> lon(7.190, 7.240);
+        nlohmann::ordered_json standsJson = nlohmann::ordered_json::object();
+        size_t asRead = 0;
+        for (size_t i = 0; i < count; i++)
+        {
+            nlohmann::ordered_json stand = nlohmann::ordered_json::object();
+            Coordinates coordinates{lat(rng), lon(rng), 20.0 + i % 25, true};
+            stand["Coordinates"] = formatCoordinates(coordinates);
+            stand["Code"] = i % 3 ? "ABC" : "DEF";
+            stand["Use"] = i % 4 ? "C" : "CP";
+            stand["Schengen"] = i % 2 == 0;
+            stand["Callsigns"] = {"AFR", "EZY"};
+            stand["Priority"] = static_cast<int>(i % 5);
+            // One stand in fifty in hand-written shapes
+            if (i % 50 == 0)
+            {
+                stand["Use"] = "PC";
+                stand["Remark"] = nlohmann::ordered_json::object();
+                asRead++;
+            }
+            standsJson["S" + std::to_string(i)] = std::move(stand);
+        }
+        nlohmann::ordered_json config = {{"ICAO", "LOAD"}, {"Coordinates", "43.666359:7.216941:20"}, {"Stands", std::move(standsJson)}};
+
+        const std::string icao = "LOAD";
+        std::string jsonPath = getBaseDir() + icao + ".json";
+        std::string cachePath = getBaseDir() + icao + ".cfgcache";
+        std::ofstream(jsonPath, std::ios::binary) << config.dump(4);
+        std::filesystem::remove(cachePath);
+
+        StandTable stands;
+        double parsedMs = loadMs(icao, stands);
+        double cachedMs = loadMs(icao, stands);
+        size_t sources = 0;
+        for (uint32_t row : stands)
+            sources += stands.source(row) != nullptr;
+        std::filesystem::remove(jsonPath);
+        std::filesystem::remove(cachePath);
+
+        std::cout << count << " stands, " << asRead << " written back as read" << std::endl;
+        std::cout << "  parsed: " << parsedMs << " ms" << std::endl;
+        std::cout << "  cached: " << cachedMs << " ms" << std::endl;
+        std::cout << "  sources kept: " << sources << std::endl;
+    }
+}
+
+int main()
+{
+    run(2000);
+    run(20000);
+    return 0;
+}
@@ -0,0 +1,204 @@
+// Validates and converts batchcopy-style coordinate lines with the previous regex
+// based isCoordinatesValid against the single-pass parseCoordinateText.
+// Build and run with: make bench && ./bench/coord_bench
+#include "utils.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <regex>
+#include <string>
+#include <vector>
+
+namespace
+{
+    // Previous implementation, kept here as the baseline
+    bool legacyIsCoordinatesValid(std::string &coordinates, bool radius)
+    {
+        // Remove "COORD:" prefix if present
+        if (coordinates.substr(0, 6) == "COORD:")
+        {
+            coordinates = coordinates.substr(6);
+        }
+
+        // Basic validation of Degree decimal format
+        size_t firstColon = coordinates.find(':');
+        size_t secondColon = coordinates.find(':', firstColon + 1);
+        if (firstColon == std::string::npos || (secondColon == std::string::npos && radius))
+        {
+            return false;
+        }
+
+        // Check if already in decimal format - allow empty radius
+        std::regex degreeDecimalRegex;
+        if (radius == false)
+        {
+            secondColon = coordinates.length();
+            degreeDecimalRegex = R"(([-+]?\d{1,3}\.\d+):([-+]?\d{1,3}\.\d+))";
+        } else {
+            degreeDecimalRegex = R"(([-+]?\d{1,3}\.\d+):([-+]?\d{1,3}\.\d+):(\d*))";
+        }
+        if (std::regex_match(coordinates, degreeDecimalRegex))
+        {
+            // Valid format : 43.666359:7.216941:20
+            std::string lat = coordinates.substr(0, firstColon);
+            std::string lon = coordinates.substr(firstColon + 1, secondColon - firstColon - 1);
+            std::string radius_;
+            if (radius == false) {
+                radius_ = "";
+            } else {
+                radius_ = coordinates.substr(secondColon + 1);
+            }
+            try
+            {
+                double latVal = std::stod(lat);
+                double lonVal = std::stod(lon);
+                if (latVal < -90 || latVal > 90 || lonVal < -180 || lonVal > 180)
+                {
+                    return false;
+                }
+                // Validate radius if provided
+                if (!radius_.empty())
+                {
+                    double radiusVal = std::stod(radius_);
+                    if (radiusVal < 9)
+                    {
+                        return false;
+                    }
+                }
+                return true;
+            }
+            catch (...)
+            {
+                return false;
+            }
+        }
+
+        // Try to convert from DMS format like N043.37.40.861:E001.22.36.064:25 or COORD:N043.37.40.861:E001.22.36.064:25
+        std::regex dmsRegex(R"([NS](\d{3})\.(\d{2})\.(\d{2})\.(\d{3}):[EW](\d{3})\.(\d{2})\.(\d{2})\.(\d{3}):(\d+))");
+        std::smatch match;
+        if (std::regex_match(coordinates, match, dmsRegex))
+        {
+            // Convert latitude
+            int latDeg = std::stoi(match[1]);
+            int latMin = std::stoi(match[2]);
+            int latSec = std::stoi(match[3]);
+            int latMillisec = std::stoi(match[4]);
+            double latDecimal = latDeg + latMin / 60.0 + (latSec + latMillisec / 1000.0) / 3600.0;
+            if (coordinates[0] == 'S') latDecimal = -latDecimal;
+
+            // Convert longitude
+            int lonDeg = std::stoi(match[5]);
+            int lonMin = std::stoi(match[6]);
+            int lonSec = std::stoi(match[7]);
+            int lonMillisec = std::stoi(match[8]);
+            double lonDecimal = lonDeg + lonMin / 60.0 + (lonSec + lonMillisec / 1000.0) / 3600.0;
+            if (coordinates.find("W") != std::string::npos) lonDecimal = -lonDecimal;
+
+            std::string radius = match[9].str();
+
+            // Validate ranges
+            if (latDecimal < -90 || latDecimal > 90 || lonDecimal < -180 || lonDecimal > 180)
+            {
+                return false;
+            }
+
+            // Update coordinates to decimal format
+            coordinates = std::to_string(latDecimal) + ":" + std::to_string(lonDecimal) + ":" + radius;
+            return true;
+        }
+
+        return false;
+    }
+
+    // Mix of decimal, COORD:-prefixed and DMS lines, one in ten malformed
+    std::vector<std::string> makeLines(size_t count)
+    {
+        std::mt19937 rng(3);
+        std::uniform_real_distribution<double> lat(43.60, 43.70);
+        std::uniform_real_distribution<double> lon(7.18, 7.25);
+        std::vector<std::string> lines;
+        lines.reserve(count);
+        char buffer[64];
+        for (size_t i = 0; i < count; i++)
+        {
+            double a = lat(rng), b = lon(rng);
+            int radius = 15 + static_cast<int>(rng() % 30);
+            switch (i % 10)
+            {
+            case 0:
+                std::snprintf(buffer, sizeof(buffer), "%.6f;%.6f:%d", a, b, radius);
+                break;
+            case 1:
+            case 2:
+                std::snprintf(buffer, sizeof(buffer), "N%03d.%02d.%02d.%03d:E%03d.%02d.%02d.%03d:%d",
+                              static_cast<int>(a), static_cast<int>(a * 60) % 60, static_cast<int>(a * 3600) % 60, static_cast<int>(a * 3600000) % 1000,
+                              static_cast<int>(b), static_cast<int>(b * 60) % 60, static_cast<int>(b * 3600) % 60, static_cast<int>(b * 3600000) % 1000, radius);
+                break;
+            case 3:
+                std::snprintf(buffer, sizeof(buffer), "COORD:%.6f:%.6f:%d", a, b, radius);
+                break;
+            default:
+                std::snprintf(buffer, sizeof(buffer), "%.6f:%.6f:%d", a, b, radius);
+            }
+            lines.push_back(buffer);
+        }
+        return lines;
+    }
+
+    template <typename F>
+    double timeMs(F &&f)
+    {
+        auto start = std::chrono::steady_clock::now();
+        f();
+        auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    }
+
+    void run(size_t count)
+    {
+        const std::vector<std::string> lines = makeLines(count);
+
+        // Legacy callers validated, then parsed the rewritten text a second time
+        std::vector<Coordinates> legacy(lines.size());
+        std::vector<char> legacyOk(lines.size());
+        double legacyMs = timeMs([&]
+                                 {
+            for (size_t i = 0; i < lines.size(); i++)
+            {
+                std::string text = lines[i];
+                legacyOk[i] = legacyIsCoordinatesValid(text, true) && parseCoordinates(text, legacy[i]);
+            } });
+
+        std::vector<CoordinateParse> parsed(lines.size());
+        double parseMs = timeMs([&]
+                                {
+            for (size_t i = 0; i < lines.size(); i++)
+                parsed[i] = parseCoordinateText(lines[i]); });
+
+        // DMS went through std::to_string before, so it only agrees to 6 decimals
+        size_t mismatches = 0;
+        for (size_t i = 0; i < lines.size(); i++)
+        {
+            if (static_cast<bool>(legacyOk[i]) != parsed[i].ok)
+                mismatches++;
+            else if (parsed[i].ok && (std::abs(legacy[i].lat - parsed[i].coordinates.lat) > 1e-6 ||
+                                      std::abs(legacy[i].lon - parsed[i].coordinates.lon) > 1e-6 ||
+                                      legacy[i].radius != parsed[i].coordinates.radius))
+                mismatches++;
+        }
+
+        std::cout << count << " lines" << std::endl;
+        std::cout << "  regex + stod:     " << legacyMs << " ms" << std::endl;
+        std::cout << "  single pass:      " << parseMs << " ms" << std::endl;
+        std::cout << "  results differ:   " << mismatches << std::endl;
+    }
+}
+
+int main()
+{
+    run(2000);
+    run(20000);
+    return 0;
+}
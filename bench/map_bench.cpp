@@ -0,0 +1,100 @@
+// Map files for synthetic airports of up to 20k stands: time to write them, bytes per stand, how
+// fast the stand data is rendered in memory and what the scheduler's snapshot costs.
+// Build and run with: make bench && ./bench/map_bench
+#include "map_generator.h"
+#include "stand_table.h"
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+
+namespace
+{
+    template <typename F>
+    double timeMs(F &&f)
+    {
+        auto start = std::chrono::steady_clock::now();
+        f();
+        auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    }
+
+    void run(size_t count)
+    {
+        // Stands scattered over about 4 x 4 km around Nice, with the settings a real
+        // config carries on most stands
+        std::mt19937 rng(7);
+        std::uniform_real_distribution<double> lat(43.645, 43.681);
+        std::uniform_real_distribution<double> lon(7.190, 7.240);
+        std::uniform_real_distribution<double> radius(15, 45);
+        StandTable stands;
+        for (size_t i = 0; i < count; i++)
+        {
+            StandRecord stand;
+            stand.hasCoordinates = true;
+            stand.coordinates = {lat(rng), lon(rng), radius(rng), true};
+            stand.code = codeMask(i % 3 ? "ABC" : "DEF");
+            stand.use = useMask(i % 4 ? "C" : "CP");
+            stand.schengen = i % 2 ? Schengen::Yes : Schengen::No;
+            stand.callsigns = {"AFR", "EZY"};
+            stand.priority = static_cast<int>(i % 5);
+            if (i % 10 == 1)
+                stand.block.push_back("S" + std::to_string(i - 1));
+            if (i % 7 == 0)
+                stand.remarks.push_back({"Note", "Tow in only"});
+            stands.insert("S" + std::to_string(i), stand);
+        }
+
+        // The first write also writes the page, later ones only the stands file
+        const std::string icao = "BENCH";
+        bool written = true;
+        double firstMs = timeMs([&]
+                                { written = writeMap(stands, icao) && written; });
+        // One moved stand, the page picks it up from the delta
+        uint32_t moved = *stands.begin();
+        Coordinates coordinates = stands.coordinates(moved);
+        coordinates.lat += 0.0001;
+        stands.setCoordinates(moved, coordinates);
+        double editMs = timeMs([&]
+                               { written = writeMap(stands, icao) && written; });
+        uintmax_t pageBytes = written ? std::filesystem::file_size(icao + "_map.html") : 0;
+        uintmax_t dataBytes = written ? std::filesystem::file_size(icao + "_stands.json") : 0;
+        uintmax_t deltaBytes = written ? std::filesystem::file_size(icao + "_delta.json") : 0;
+        std::filesystem::remove(icao + "_map.html");
+        std::filesystem::remove(icao + "_stands.json");
+        std::filesystem::remove(icao + "_delta.json");
+
+        // Render throughput without the disk: stands file plus an empty delta per render
+        const int renders = 20;
+        setMapFilesWritten(false);
+        double renderMs = timeMs([&]
+                                 {
+                                     for (int i = 0; i < renders; i++)
+                                         written = writeMap(stands, icao) && written; });
+        setMapFilesWritten(true);
+
+        // RenderScheduler::markDirty copies the table on the prompt thread after every edit
+        const int snapshots = 100;
+        double snapshotMs = timeMs([&]
+                                   {
+                                       for (int i = 0; i < snapshots; i++)
+                                           std::make_shared<const StandTable>(stands); });
+        double megabytesPerSecond = static_cast<double>(dataBytes) * renders / (renderMs / 1000) / 1e6;
+
+        std::cout << count << " stands" << std::endl;
+        std::cout << "  first write: " << firstMs << " ms, page " << pageBytes << " bytes" << std::endl;
+        std::cout << "  edit: " << editMs << " ms, data " << dataBytes << " bytes (" << dataBytes / count << " per stand), delta " << deltaBytes << " bytes" << std::endl;
+        std::cout << "  render: " << renderMs / renders << " ms, " << megabytesPerSecond << " MB/s" << std::endl;
+        std::cout << "  snapshot: " << snapshotMs / snapshots << " ms" << std::endl;
+    }
+}
+
+int main()
+{
+    run(200);
+    run(2000);
+    run(20000);
+    return 0;
+}
@@ -0,0 +1,147 @@
+// Compares natural sorting of stand names with the previous per-comparison parser
+// against sorting on precomputed NaturalKey values.
+// Build and run with: make bench && ./bench/natural_sort_bench
+#include "utils.h"
+#include "stand_table.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+    // Previous implementation, kept here as the baseline
+    std::vector<std::pair<std::string, std::string>> legacyParseStandName(const std::string &standName)
+    {
+        std::vector<std::pair<std::string, std::string>> parts;
+        std::string current = "";
+        bool isNumber = false;
+        for (char c : standName)
+        {
+            bool currentIsDigit = std::isdigit(c);
+            if (currentIsDigit != isNumber && !current.empty())
+            {
+                parts.push_back({current, isNumber ? "number" : "text"});
+                current = "";
+            }
+            current += c;
+            isNumber = currentIsDigit;
+        }
+        if (!current.empty())
+            parts.push_back({current, isNumber ? "number" : "text"});
+        return parts;
+    }
+
+    bool legacyNaturalSort(const std::string &a, const std::string &b)
+    {
+        auto partsA = legacyParseStandName(a);
+        auto partsB = legacyParseStandName(b);
+        size_t minSize = std::min(partsA.size(), partsB.size());
+        for (size_t i = 0; i < minSize; ++i)
+        {
+            const auto &partA = partsA[i];
+            const auto &partB = partsB[i];
+            if (partA.second == "number" && partB.second == "number")
+            {
+                int numA = std::stoi(partA.first);
+                int numB = std::stoi(partB.first);
+                if (numA != numB)
+                    return numA < numB;
+            }
+            else if (partA.second == "text" && partB.second == "text")
+            {
+                if (partA.first != partB.first)
+                    return partA.first < partB.first;
+            }
+            else
+            {
+                return partA.second == "number" && partB.second == "text";
+            }
+        }
+        return partsA.size() < partsB.size();
+    }
+
+    // Names shaped like real stands: A12, T2B45L, 105, GA7 ...
+    std::vector<std::string> makeNames(size_t count)
+    {
+        std::mt19937 rng(42);
+        const char *prefixes[] = {"", "A", "B", "C", "GA", "T1", "T2B", "W", "REM"};
+        const char *suffixes[] = {"", "", "", "L", "R", "A", "B"};
+        std::vector<std::string> names;
+        names.reserve(count);
+        for (size_t i = 0; i < count; i++)
+        {
+            std::string name = prefixes[rng() % 9];
+            name += std::to_string(rng() % 2000);
+            name += suffixes[rng() % 7];
+            names.push_back(name);
+        }
+        return names;
+    }
+
+    template <typename F>
+    double timeMs(F &&f)
+    {
+        auto start = std::chrono::steady_clock::now();
+        f();
+        auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    }
+
+    void run(size_t count)
+    {
+        const std::vector<std::string> names = makeNames(count);
+
+        std::vector<std::string> legacy = names;
+        double legacyMs = timeMs([&]
+                                 { std::sort(legacy.begin(), legacy.end(), legacyNaturalSort); });
+
+        std::vector<std::string> keyed;
+        double keyedMs = timeMs([&]
+                                {
+            std::vector<std::pair<NaturalKey, uint32_t>> keys;
+            keys.reserve(names.size());
+            for (uint32_t i = 0; i < names.size(); i++)
+                keys.emplace_back(naturalKey(names[i]), i);
+            std::sort(keys.begin(), keys.end());
+            keyed.reserve(names.size());
+            for (const auto &key : keys)
+                keyed.push_back(names[key.second]); });
+
+        // The table keeps a sorted index, so save/list only walk it
+        StandTable table;
+        double insertMs = timeMs([&]
+                                 {
+            for (const std::string &name : names)
+                table.insert(name, StandRecord()); });
+        std::vector<uint32_t> rows;
+        rows.reserve(table.size());
+        double walkMs = timeMs([&]
+                               {
+            for (uint32_t row : table.sorted())
+                rows.push_back(row); });
+
+        bool agrees = true;
+        for (size_t i = 1; i < keyed.size(); i++)
+        {
+            if (legacyNaturalSort(keyed[i], keyed[i - 1]))
+                agrees = false;
+        }
+
+        std::cout << count << " names (" << table.size() << " unique)" << std::endl;
+        std::cout << "  parse per comparison: " << legacyMs << " ms" << std::endl;
+        std::cout << "  build keys + sort:    " << keyedMs << " ms" << std::endl;
+        std::cout << "  table inserts:        " << insertMs << " ms" << std::endl;
+        std::cout << "  sorted index walk:    " << walkMs << " ms" << std::endl;
+        std::cout << "  same order as legacy: " << (agrees ? "yes" : "NO") << std::endl;
+    }
+}
+
+int main()
+{
+    run(10000);
+    run(100000);
+    return 0;
+}
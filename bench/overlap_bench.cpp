@@ -0,0 +1,71 @@
+// Full overlap check of a synthetic airport: naive all-pairs haversine against
+// findOverlaps (spatial hash broad phase, SIMD narrow phase).
+// Build and run with: make bench && ./bench/overlap_bench
+#include "overlap_engine.h"
+#include "spatial_index.h"
+#include "stand_table.h"
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+
+namespace
+{
+    template <typename F>
+    double timeMs(F &&f)
+    {
+        auto start = std::chrono::steady_clock::now();
+        f();
+        auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    }
+
+    void run(size_t count)
+    {
+        // Stands scattered over about 4 x 4 km around Nice, radius 15 to 45 m
+        std::mt19937 rng(7);
+        std::uniform_real_distribution<double> lat(43.645, 43.681);
+        std::uniform_real_distribution<double> lon(7.190, 7.240);
+        std::uniform_real_distribution<double> radius(15, 45);
+        StandTable stands;
+        for (size_t i = 0; i < count; i++)
+        {
+            StandRecord stand;
+            stand.hasCoordinates = true;
+            stand.coordinates = {lat(rng), lon(rng), radius(rng), true};
+            if (i % 10 == 1)
+                stand.block.push_back("S" + std::to_string(i - 1));
+            stands.insert("S" + std::to_string(i), stand);
+        }
+
+        size_t naivePairs = 0;
+        std::vector<uint32_t> rows(stands.begin(), stands.end());
+        double naiveMs = timeMs([&]
+                                {
+            for (size_t a = 0; a < rows.size(); a++)
+            {
+                for (size_t b = a + 1; b < rows.size(); b++)
+                {
+                    double distance = distanceMeters(stands.lat(rows[a]), stands.lon(rows[a]), stands.lat(rows[b]), stands.lon(rows[b]));
+                    if (distance < stands.standRadius(rows[a]) + stands.standRadius(rows[b]) && !blocksEachOther(stands, rows[a], rows[b]))
+                        naivePairs++;
+                }
+            } });
+
+        std::vector<StandConflict> conflicts;
+        double engineMs = timeMs([&]
+                                 { conflicts = findOverlaps(stands); });
+
+        std::cout << count << " stands" << std::endl;
+        std::cout << "  naive haversine: " << naiveMs << " ms, " << naivePairs << " conflicts" << std::endl;
+        std::cout << "  findOverlaps:    " << engineMs << " ms, " << conflicts.size() << " conflicts" << std::endl;
+    }
+}
+
+int main()
+{
+    run(1000);
+    run(5000);
+    run(20000);
+    return 0;
+}
@@ -0,0 +1,124 @@
+#include "config_cache.h"
+#include "json_writer.h"
+#include "mapped_file.h"
+#include <cstring>
+#include <filesystem>
+
+namespace
+{
+    constexpr char cacheMagic[8] = {'N', 'S', 'C', 'F', 'G', 'C', 'C', 'H'};
+    // Bump whenever the snapshot layout changes
+    constexpr uint32_t cacheVersion = 2;
+
+    struct CacheHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t endianness; // 1 as written by the producing machine
+        uint64_t jsonSize;
+        int64_t jsonMtime;
+        uint64_t jsonHash;
+        uint64_t configSize;  // bytes of top-level config JSON text following the header
+        uint64_t payloadHash; // everything after the header, catches a damaged cache
+    };
+
+    // 64-bit multiply-xorshift hash over 8-byte words, fast enough to run on every startup
+    uint64_t hashContent(const char *data, size_t size)
+    {
+        const uint64_t prime = 0x9E3779B97F4A7C15ull;
+        uint64_t hash = size * prime;
+        size_t i = 0;
+        for (; i + 8 <= size; i += 8)
+        {
+            uint64_t word;
+            std::memcpy(&word, data + i, 8);
+            hash = (hash ^ word) * prime;
+            hash ^= hash >> 32;
+        }
+        uint64_t tail = 0;
+        std::memcpy(&tail, data + i, size - i);
+        hash = (hash ^ tail) * prime;
+        return hash ^ (hash >> 29);
+    }
+
+    // Fills size, mtime and hash of the JSON file, false if it cannot be read
+    bool describeJson(const std::string &jsonPath, CacheHeader &header)
+    {
+        std::error_code error;
+        auto mtime = std::filesystem::last_write_time(jsonPath, error);
+        if (error)
+            return false;
+        MappedFile json;
+        if (!json.open(jsonPath))
+            return false;
+        header.jsonSize = json.size();
+        header.jsonMtime = static_cast<int64_t>(mtime.time_since_epoch().count());
+        header.jsonHash = hashContent(json.data(), json.size());
+        return true;
+    }
+}
+
+bool loadConfigCache(const std::string &jsonPath, const std::string &cachePath, nlohmann::ordered_json &configJson, StandTable &stands)
+{
+    MappedFile cache;
+    if (!cache.open(cachePath) || cache.size() < sizeof(CacheHeader))
+        return false;
+    CacheHeader header;
+    std::memcpy(&header, cache.data(), sizeof(header));
+    if (std::memcmp(header.magic, cacheMagic, sizeof(cacheMagic)) != 0 || header.version != cacheVersion || header.endianness != 1)
+        return false;
+
+    // Cheap checks first, the content hash only runs when size and mtime still match
+    std::error_code error;
+    if (std::filesystem::file_size(jsonPath, error) != header.jsonSize || error)
+        return false;
+    CacheHeader current;
+    if (!describeJson(jsonPath, current) || current.jsonSize != header.jsonSize || current.jsonMtime != header.jsonMtime ||
+        current.jsonHash != header.jsonHash)
+        return false;
+
+    const char *data = cache.data() + sizeof(header);
+    if (static_cast<size_t>(cache.end() - data) < header.configSize ||
+        hashContent(data, static_cast<size_t>(cache.end() - data)) != header.payloadHash)
+        return false;
+    try
+    {
+        nlohmann::ordered_json config = nlohmann::ordered_json::parse(data, data + header.configSize);
+        data += header.configSize;
+        if (!stands.readSnapshot(data, cache.end()) || data != cache.end())
+        {
+            stands.clear();
+            return false;
+        }
+        configJson = std::move(config);
+    }
+    catch (const std::exception &)
+    {
+        stands.clear();
+        return false;
+    }
+    return true;
+}
+
+void writeConfigCache(const std::string &jsonPath, const std::string &cachePath, const nlohmann::ordered_json &configJson, const StandTable &stands)
+{
+    CacheHeader header{};
+    std::memcpy(header.magic, cacheMagic, sizeof(cacheMagic));
+    header.version = cacheVersion;
+    header.endianness = 1;
+    if (!describeJson(jsonPath, header))
+        return;
+    std::string config = configJson.dump();
+    header.configSize = config.size();
+
+    std::string out(sizeof(header), '\0');
+    out += config;
+    stands.writeSnapshot(out);
+    header.payloadHash = hashContent(out.data() + sizeof(header), out.size() - sizeof(header));
+    std::memcpy(&out[0], &header, sizeof(header));
+
+    // A missing or stale cache only costs a JSON parse, so failures are silent
+    AtomicFile file(cachePath);
+    if (file.isOpen() && file.write(out.data(), out.size()))
+        file.commit();
+}
@@ -0,0 +1,10 @@
+#pragma once
+#include <string>
+#include "nlohmann/json.hpp"
+#include "stand_table.h"
+
+// Binary snapshot of a parsed config stored next to it as <ICAO>.cfgcache. The
+// snapshot is only used while the JSON still has the size, mtime and content hash
+// it was taken from.
+bool loadConfigCache(const std::string &jsonPath, const std::string &cachePath, nlohmann::ordered_json &configJson, StandTable &stands);
+void writeConfigCache(const std::string &jsonPath, const std::string &cachePath, const nlohmann::ordered_json &configJson, const StandTable &stands);
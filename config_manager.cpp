@@ -1,12 +1,215 @@
 #include "config_manager.h"
 #include "utils.h"
 #include "map_generator.h"
+#include "json_writer.h"
+#include "mapped_file.h"
+#include "config_cache.h"
 #include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <algorithm>
 
-bool getConfig(const std::string &icao, nlohmann::ordered_json &configJson, bool& mapGenerated)
+namespace
 {
+    // SAX handler filling the stand table straight from the parser events. Only
+    // values the model does not type (top-level settings, unknown or malformed stand
+    // keys) are built as JSON; the Stands object itself is never materialized.
+    class ConfigLoader : public nlohmann::json_sax<nlohmann::ordered_json>
+    {
+    public:
+        ConfigLoader(nlohmann::ordered_json &config, StandTable &stands) : config_(config), stands_(stands) {}
+
+        bool null() override { return scalar(nullptr); }
+        bool boolean(bool val) override { return scalar(val); }
+        bool number_integer(number_integer_t val) override { return scalar(val); }
+        bool number_unsigned(number_unsigned_t val) override { return scalar(val); }
+        bool number_float(number_float_t val, const string_t &) override { return scalar(val); }
+        bool string(string_t &val) override { return scalar(std::move(val)); }
+        bool binary(binary_t &val) override { return scalar(nlohmann::ordered_json::binary(std::move(val))); }
+
+        bool start_object(std::size_t) override
+        {
+            if (stack_.empty())
+            {
+                if (level_ == Level::Document)
+                {
+                    config_ = nlohmann::ordered_json::object();
+                    level_ = Level::Config;
+                    return true;
+                }
+                if (level_ == Level::Config && key_ == "Stands")
+                {
+                    config_[key_] = nlohmann::ordered_json::object();
+                    level_ = Level::Stands;
+                    return true;
+                }
+                if (level_ == Level::Stands)
+                {
+                    record_ = StandRecord();
+                    source_.reset();
+                    level_ = Level::Stand;
+                    return true;
+                }
+            }
+            return open(nlohmann::ordered_json::object());
+        }
+
+        bool start_array(std::size_t) override { return open(nlohmann::ordered_json::array()); }
+
+        bool key(string_t &val) override
+        {
+            if (stack_.empty() && level_ == Level::Stands)
+                standName_ = std::move(val);
+            else if (stack_.empty() && level_ == Level::Stand)
+                field_ = std::move(val);
+            else
+                key_ = std::move(val);
+            return true;
+        }
+
+        bool end_object() override
+        {
+            if (!stack_.empty())
+                return close();
+            if (level_ == Level::Stand)
+            {
+                addStand();
+                level_ = Level::Stands;
+            }
+            else if (level_ == Level::Stands)
+                level_ = Level::Config;
+            else
+                level_ = Level::Document;
+            return true;
+        }
+
+        bool end_array() override { return close(); }
+
+        bool parse_error(std::size_t, const std::string &, const nlohmann::detail::exception &ex) override
+        {
+            error_ = ex.what();
+            return false;
+        }
+
+        const std::string &error() const { return error_; }
+
+    private:
+        enum class Level
+        {
+            Document, // before or after the root value
+            Config,   // inside the root object
+            Stands,   // inside "Stands"
+            Stand     // inside one stand
+        };
+
+        // Where a value completed outside any generic container goes
+        nlohmann::ordered_json *slot()
+        {
+            switch (level_)
+            {
+            case Level::Document:
+                return &config_;
+            case Level::Config:
+                return &config_[key_];
+            default:
+                return &scratch_;
+            }
+        }
+
+        nlohmann::ordered_json *child(nlohmann::ordered_json &&value)
+        {
+            if (stack_.empty())
+            {
+                nlohmann::ordered_json *target = slot();
+                *target = std::move(value);
+                return target;
+            }
+            nlohmann::ordered_json &parent = *stack_.back();
+            if (parent.is_array())
+            {
+                parent.push_back(std::move(value));
+                return &parent.back();
+            }
+            nlohmann::ordered_json &member = parent[key_];
+            member = std::move(value);
+            return &member;
+        }
+
+        bool scalar(nlohmann::ordered_json &&value)
+        {
+            child(std::move(value));
+            if (stack_.empty())
+                complete();
+            return true;
+        }
+
+        bool open(nlohmann::ordered_json &&container)
+        {
+            // Children are only added to the innermost container, so these pointers stay valid
+            stack_.push_back(child(std::move(container)));
+            return true;
+        }
+
+        bool close()
+        {
+            stack_.pop_back();
+            if (stack_.empty())
+                complete();
+            return true;
+        }
+
+        // A whole value was read at a stand table level
+        void complete()
+        {
+            if (level_ == Level::Stand)
+            {
+                // Stands are only buffered from the first key toJson would not write back as read
+                record_.applyField(field_, scratch_, &source_);
+                if (source_)
+                    (*source_)[field_] = std::move(scratch_);
+            }
+            else if (level_ == Level::Stands)
+            {
+                // Not an object: the stand exists but has no settings
+                record_ = StandRecord();
+                source_ = std::move(scratch_);
+                addStand();
+            }
+        }
+
+        void addStand()
+        {
+            // Like the DOM parser, a repeated name keeps its first position and the last value
+            uint32_t row = stands_.find(standName_);
+            if (row == StandTable::npos)
+                row = stands_.insert(standName_, record_);
+            else
+                stands_.setRecord(row, record_);
+            // Saving writes a flagged stand back as read unless it gets edited; a repeated
+            // name must not keep the source of its earlier value
+            if (source_ || stands_.source(row))
+                stands_.setSource(row, std::move(source_));
+        }
+
+        nlohmann::ordered_json &config_;
+        StandTable &stands_;
+        Level level_ = Level::Document;
+        std::vector<nlohmann::ordered_json *> stack_;
+        std::string key_;
+        std::string standName_;
+        std::string field_;
+        StandRecord record_;
+        std::optional<nlohmann::ordered_json> source_;
+        nlohmann::ordered_json scratch_;
+        std::string error_;
+    };
+}
+
+bool getConfig(const std::string &icao, nlohmann::ordered_json &configJson, StandTable &stands, bool& mapGenerated)
+{
+    configJson = nlohmann::ordered_json();
+    stands.clear();
+
     std::string baseDir = getBaseDir();
     std::cout << "Config directory path: " << baseDir << std::endl;
     
@@ -34,18 +237,40 @@ bool getConfig(const std::string &icao, nlohmann::ordered_json &configJson, bool
     else
     {
         std::cout << "Config file found: " << icao << ".json" << std::endl;
-        std::ifstream inputFile(baseDir + icao + ".json");
-        if (inputFile)
+        std::string jsonPath = baseDir + icao + ".json";
+        std::string cachePath = baseDir + icao + ".cfgcache";
+        MappedFile inputFile;
+        if (loadConfigCache(jsonPath, cachePath, configJson, stands))
         {
+            // JSON unchanged since the snapshot was taken, nothing to parse
+        }
+        else if (inputFile.open(jsonPath))
+        {
+            // Stands go straight into the table, configJson keeps an empty "Stands" placeholder for its position
+            ConfigLoader loader(configJson, stands);
+            bool parsed = false;
             try
             {
-                inputFile >> configJson;
+                parsed = nlohmann::ordered_json::sax_parse(inputFile.begin(), inputFile.end(), &loader,
+                                                           nlohmann::ordered_json::input_format_t::json, false);
             }
             catch (const std::exception &e)
             {
                 std::cout << "Error reading JSON: " << e.what() << std::endl;
                 return false;
             }
+            if (!parsed)
+            {
+                std::cout << "Error reading JSON: " << loader.error() << std::endl;
+                return false;
+            }
+            if (configJson.contains("Stands") && !configJson["Stands"].is_object())
+            {
+                // "Stands" was not an object, the table is empty like before
+                stands.clear();
+                configJson["Stands"] = nlohmann::ordered_json::object();
+            }
+            writeConfigCache(jsonPath, cachePath, configJson, stands);
         }
         else
         {
@@ -79,46 +304,169 @@ bool getConfig(const std::string &icao, nlohmann::ordered_json &configJson, bool
             {"version", "v1.0.0"},
             {"ICAO", icao},
             {"Coordinates", coordinates},
-            {"Stands", {}}};
+            {"Stands", nlohmann::ordered_json::object()}};
         std::cout << "Created default config structure." << std::endl;
         // Generate an initial map file for live-reload/debugging
-        generateMap(configJson, icao, true);
+        generateMap(stands, icao, true);
         mapGenerated = true;
     }
 
     return true;
 }
 
-void saveFile(const std::string &icao, const nlohmann::ordered_json &configJson)
+// Writes one stand straight from the table columns, same keys and order as StandRecord::toJson.
+// Stands not edited since they were read and that the columns would normalize go out as read.
+static void writeStand(JsonWriter &writer, const StandTable &stands, uint32_t row)
+{
+    auto writeList = [&](const char *name, uint32_t listId)
+    {
+        if (listId == StandTable::emptyList)
+            return;
+        writer.key(name);
+        writer.beginArray();
+        for (uint32_t id : stands.list(listId))
+            writer.value(stands.string(id));
+        writer.endArray();
+    };
+
+    if (const nlohmann::ordered_json *source = stands.source(row))
+    {
+        writer.value(*source);
+        return;
+    }
+
+    writer.beginObject();
+    if (stands.hasCoordinates(row))
+    {
+        writer.key("Coordinates");
+        writer.value(formatCoordinates(stands.coordinates(row)));
+    }
+    if (stands.code(row))
+    {
+        writer.key("Code");
+        writer.value(codeString(stands.code(row)));
+    }
+    if (stands.use(row))
+    {
+        writer.key("Use");
+        writer.value(useString(stands.use(row)));
+    }
+    if (stands.schengen(row) != Schengen::Unset)
+    {
+        writer.key("Schengen");
+        writer.value(stands.schengen(row) == Schengen::Yes);
+    }
+    writeList("Callsigns", stands.callsigns(row));
+    writeList("Countries", stands.countries(row));
+    writeList("Block", stands.block(row));
+    const std::vector<uint32_t> &remarks = stands.list(stands.remarks(row));
+    if (!remarks.empty())
+    {
+        writer.key("Remark");
+        writer.beginObject();
+        for (size_t i = 0; i + 1 < remarks.size(); i += 2)
+        {
+            writer.key(stands.string(remarks[i]));
+            writer.value(stands.string(remarks[i + 1]));
+        }
+        writer.endObject();
+    }
+    if (std::optional<int> wingspan = stands.wingspan(row))
+    {
+        writer.key("Wingspan");
+        writer.value(*wingspan);
+    }
+    if (std::optional<int> priority = stands.priority(row))
+    {
+        writer.key("Priority");
+        writer.value(*priority);
+    }
+    if (const Apron *apron = stands.apron(row))
+    {
+        writer.key("Apron");
+        writer.beginObject();
+        writer.key("Size");
+        writer.value(apron->size);
+        if (!apron->coordinates.empty())
+        {
+            writer.key("Coordinates");
+            writer.beginArray();
+            for (const std::string &coordinates : apron->coordinates)
+                writer.value(coordinates);
+            writer.endArray();
+        }
+        writer.endObject();
+    }
+    if (const nlohmann::ordered_json *extra = stands.extra(row))
+    {
+        // setRecord drops extra keys shadowed by typed values, so names never repeat
+        for (auto it = extra->begin(); it != extra->end(); ++it)
+        {
+            writer.key(it.key());
+            writer.value(it.value());
+        }
+    }
+    writer.endObject();
+}
+
+// Saving an unedited config gives back the file as read, except that stands are put in
+// natural order, whitespace becomes dump(4) indentation without a final newline, and a
+// repeated key keeps its first position with its last value
+void saveFile(const std::string &icao, const nlohmann::ordered_json &configJson, const StandTable &stands)
 {
     std::string baseDir = getBaseDir();
-    std::ofstream outputFile(baseDir + icao + ".json");
-    if (outputFile)
+    // Written to <ICAO>.json.tmp, then fsynced and renamed over the config
+    AtomicFile outputFile(baseDir + icao + ".json");
+    if (!outputFile.isOpen())
     {
-        nlohmann::ordered_json sortedStands;
-        if (configJson.contains("Stands") && configJson["Stands"].is_object())
+        std::cout << RED << "Error opening file for writing." << std::endl;
+        return;
+    }
+
+    JsonWriter writer(outputFile);
+    auto writeStands = [&]()
+    {
+        writer.key("Stands");
+        writer.beginObject();
+        // The table keeps its natural order index up to date, no sort needed
+        for (uint32_t row : stands.sorted())
+        {
+            writer.key(stands.name(row));
+            writeStand(writer, stands, row);
+        }
+        writer.endObject();
+    };
+
+    bool standsWritten = false;
+    writer.beginObject();
+    if (configJson.is_object())
+    {
+        for (auto it = configJson.begin(); it != configJson.end(); ++it)
         {
-            std::vector<std::string> standKeys;
-            for (auto &[key, value] : configJson["Stands"].items())
+            if (it.key() == "Stands")
             {
-                standKeys.push_back(key);
+                writeStands();
+                standsWritten = true;
             }
-            // Use natural sort instead of standard sort
-            std::sort(standKeys.begin(), standKeys.end(), naturalSort);
-            for (const auto &key : standKeys)
+            else
             {
-                sortedStands[key] = configJson["Stands"][key];
+                writer.key(it.key());
+                writer.value(it.value());
             }
         }
-        nlohmann::ordered_json finalJson = configJson;
-        finalJson["Stands"] = sortedStands;
-        outputFile << finalJson.dump(4);
+    }
+    if (!standsWritten)
+        writeStands();
+    writer.endObject();
+
+    if (writer.flush() && outputFile.commit())
+    {
         std::cout << GREEN << "Config file saved: " << icao << ".json" << std::endl;
-        outputFile.close();
+        // Refresh the snapshot so the next start skips parsing what was just written
+        writeConfigCache(baseDir + icao + ".json", baseDir + icao + ".cfgcache", configJson, stands);
     }
     else
     {
-        std::cout << RED << "Error opening file for writing." << std::endl;
-        return;
+        std::cout << RED << "Error writing config file, previous version kept." << std::endl;
     }
 }
@@ -1,6 +1,7 @@
 #pragma once
 #include <string>
 #include "nlohmann/json.hpp"
+#include "stand_table.h"
 
-bool getConfig(const std::string &icao, nlohmann::ordered_json &configJson, bool& mapGenerated);
-void saveFile(const std::string &icao, const nlohmann::ordered_json &configJson);
+bool getConfig(const std::string &icao, nlohmann::ordered_json &configJson, StandTable &stands, bool& mapGenerated);
+void saveFile(const std::string &icao, const nlohmann::ordered_json &configJson, const StandTable &stands);
@@ -0,0 +1,240 @@
+#include "coordinate_batch.h"
+#include "utils.h"
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#include <immintrin.h>
+#define BATCH_HAVE_SIMD 1
+#endif
+
+namespace
+{
+    // Appends the offset of every ':' and '\n' in [from, size)
+    void delimitersScalar(const char *data, size_t from, size_t size, std::vector<uint32_t> &out)
+    {
+        for (size_t i = from; i < size; i++)
+        {
+            if (data[i] == ':' || data[i] == '\n')
+                out.push_back(static_cast<uint32_t>(i));
+        }
+    }
+
+#ifdef BATCH_HAVE_SIMD
+    __attribute__((target("sse2"))) void delimitersSse2(const char *data, size_t size, std::vector<uint32_t> &out)
+    {
+        const __m128i colon = _mm_set1_epi8(':');
+        const __m128i newline = _mm_set1_epi8('\n');
+        size_t i = 0;
+        for (; i + 16 <= size; i += 16)
+        {
+            __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+            unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(
+                _mm_or_si128(_mm_cmpeq_epi8(block, colon), _mm_cmpeq_epi8(block, newline))));
+            while (mask)
+            {
+                out.push_back(static_cast<uint32_t>(i + __builtin_ctz(mask)));
+                mask &= mask - 1;
+            }
+        }
+        delimitersScalar(data, i, size, out);
+    }
+
+    __attribute__((target("avx2"))) void delimitersAvx2(const char *data, size_t size, std::vector<uint32_t> &out)
+    {
+        const __m256i colon = _mm256_set1_epi8(':');
+        const __m256i newline = _mm256_set1_epi8('\n');
+        size_t i = 0;
+        for (; i + 32 <= size; i += 32)
+        {
+            __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+            unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(
+                _mm256_or_si256(_mm256_cmpeq_epi8(block, colon), _mm256_cmpeq_epi8(block, newline))));
+            while (mask)
+            {
+                out.push_back(static_cast<uint32_t>(i + __builtin_ctz(mask)));
+                mask &= mask - 1;
+            }
+        }
+        delimitersScalar(data, i, size, out);
+    }
+#endif
+
+    void findDelimiters(const char *data, size_t size, std::vector<uint32_t> &out)
+    {
+#ifdef BATCH_HAVE_SIMD
+        if (__builtin_cpu_supports("avx2"))
+            return delimitersAvx2(data, size, out);
+        if (__builtin_cpu_supports("sse2"))
+            return delimitersSse2(data, size, out);
+#endif
+        delimitersScalar(data, 0, size, out);
+    }
+
+    // Marks out-of-range rows of [from, size) that parsed cleanly
+    void checkRangesScalar(CoordinateBatch &batch, size_t from)
+    {
+        for (size_t i = from; i < batch.size(); i++)
+        {
+            if (batch.errors[i] != BatchError::None)
+                continue;
+            if (batch.lat[i] < -90 || batch.lat[i] > 90)
+                batch.errors[i] = BatchError::LatitudeRange;
+            else if (batch.lon[i] < -180 || batch.lon[i] > 180)
+                batch.errors[i] = BatchError::LongitudeRange;
+            else if (batch.hasRadius[i] && batch.radius[i] < MIN_RADIUS)
+                batch.errors[i] = BatchError::RadiusRange;
+        }
+    }
+
+#ifdef BATCH_HAVE_SIMD
+    __attribute__((target("avx2"))) void checkRangesAvx2(CoordinateBatch &batch)
+    {
+        const __m256d signBit = _mm256_set1_pd(-0.0);
+        const __m256d maxLat = _mm256_set1_pd(90);
+        const __m256d maxLon = _mm256_set1_pd(180);
+        const __m256d minRadius = _mm256_set1_pd(MIN_RADIUS);
+        size_t i = 0;
+        for (; i + 4 <= batch.size(); i += 4)
+        {
+            __m256d lat = _mm256_andnot_pd(signBit, _mm256_loadu_pd(&batch.lat[i]));
+            __m256d lon = _mm256_andnot_pd(signBit, _mm256_loadu_pd(&batch.lon[i]));
+            int latBad = _mm256_movemask_pd(_mm256_cmp_pd(lat, maxLat, _CMP_GT_OQ));
+            int lonBad = _mm256_movemask_pd(_mm256_cmp_pd(lon, maxLon, _CMP_GT_OQ));
+            int radiusBad = _mm256_movemask_pd(_mm256_cmp_pd(_mm256_loadu_pd(&batch.radius[i]), minRadius, _CMP_LT_OQ));
+            int bad = latBad | lonBad | radiusBad;
+            // Almost every group is clean, only flagged lanes are looked at again
+            while (bad)
+            {
+                int lane = __builtin_ctz(bad);
+                bad &= bad - 1;
+                size_t row = i + lane;
+                if (batch.errors[row] != BatchError::None)
+                    continue;
+                if (latBad >> lane & 1)
+                    batch.errors[row] = BatchError::LatitudeRange;
+                else if (lonBad >> lane & 1)
+                    batch.errors[row] = BatchError::LongitudeRange;
+                else if (batch.hasRadius[row])
+                    batch.errors[row] = BatchError::RadiusRange;
+            }
+        }
+        checkRangesScalar(batch, i);
+    }
+#endif
+
+    void checkRanges(CoordinateBatch &batch)
+    {
+#ifdef BATCH_HAVE_SIMD
+        if (__builtin_cpu_supports("avx2"))
+            return checkRangesAvx2(batch);
+#endif
+        checkRangesScalar(batch, 0);
+    }
+}
+
+const char *batchErrorText(BatchError error)
+{
+    switch (error)
+    {
+    case BatchError::None:
+        return "ok";
+    case BatchError::FieldCount:
+        return "expected name:lat:lon:radius";
+    case BatchError::EmptyName:
+        return "missing stand name";
+    case BatchError::Latitude:
+        return "malformed latitude";
+    case BatchError::Longitude:
+        return "malformed longitude";
+    case BatchError::Radius:
+        return "malformed radius";
+    case BatchError::LatitudeRange:
+        return "latitude must be between -90 and 90";
+    case BatchError::LongitudeRange:
+        return "longitude must be between -180 and 180";
+    case BatchError::RadiusRange:
+        return "radius must be at least 9 meters";
+    }
+    return "unknown error";
+}
+
+CoordinateBatch parseCoordinateBatch(std::string_view buffer)
+{
+    CoordinateBatch batch;
+    const char *data = buffer.data();
+    std::vector<uint32_t> delimiters;
+    delimiters.reserve(buffer.size() / 8);
+    findDelimiters(data, buffer.size(), delimiters);
+    // A final line without '\n' ends at the buffer end
+    delimiters.push_back(static_cast<uint32_t>(buffer.size()));
+
+    size_t expected = delimiters.size() / 4 + 1;
+    batch.names.reserve(expected);
+    batch.lines.reserve(expected);
+    batch.lat.reserve(expected);
+    batch.lon.reserve(expected);
+    batch.radius.reserve(expected);
+    batch.hasRadius.reserve(expected);
+    batch.errors.reserve(expected);
+
+    size_t lineStart = 0;
+    uint32_t lineNumber = 0;
+    uint32_t colons[3];
+    size_t colonCount = 0;
+    for (uint32_t position : delimiters)
+    {
+        if (position < buffer.size() && data[position] == ':')
+        {
+            if (colonCount < 3)
+                colons[colonCount] = position;
+            colonCount++;
+            continue;
+        }
+
+        lineNumber++;
+        size_t lineEnd = position;
+        if (lineEnd > lineStart && data[lineEnd - 1] == '\r')
+            lineEnd--;
+        if (lineEnd > lineStart)
+        {
+            BatchError error = BatchError::None;
+            double lat = 0, lon = 0, radius = 0;
+            bool hasRadius = false;
+            std::string_view name;
+            if (colonCount != 3)
+            {
+                error = BatchError::FieldCount;
+                name = buffer.substr(lineStart, (colonCount ? colons[0] : lineEnd) - lineStart);
+            }
+            else
+            {
+                name = buffer.substr(lineStart, colons[0] - lineStart);
+                std::string_view radiusText = buffer.substr(colons[2] + 1, lineEnd - colons[2] - 1);
+                hasRadius = !radiusText.empty();
+                if (name.empty())
+                    error = BatchError::EmptyName;
+                else if (!parseCoordinateAxis(buffer.substr(colons[0] + 1, colons[1] - colons[0] - 1), true, lat))
+                    error = BatchError::Latitude;
+                else if (!parseCoordinateAxis(buffer.substr(colons[1] + 1, colons[2] - colons[1] - 1), false, lon))
+                    error = BatchError::Longitude;
+                else if (hasRadius && !parseCoordinateNumber(radiusText, radius))
+                    error = BatchError::Radius;
+            }
+            if (error != BatchError::None)
+            {
+                lat = lon = radius = 0;
+                hasRadius = false;
+            }
+            batch.names.push_back(name);
+            batch.lines.push_back(lineNumber);
+            batch.lat.push_back(lat);
+            batch.lon.push_back(lon);
+            batch.radius.push_back(radius);
+            batch.hasRadius.push_back(hasRadius);
+            batch.errors.push_back(error);
+        }
+        lineStart = position + 1;
+        colonCount = 0;
+    }
+
+    checkRanges(batch);
+    return batch;
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// Why a batch line was rejected
+enum class BatchError : uint8_t
+{
+    None,
+    FieldCount, // not exactly name:lat:lon:radius
+    EmptyName,
+    Latitude,
+    Longitude,
+    Radius,
+    LatitudeRange,
+    LongitudeRange,
+    RadiusRange
+};
+
+const char *batchErrorText(BatchError error);
+
+// One entry per non-empty input line, kept as parallel columns. Names point into the
+// parsed buffer, which must outlive the batch.
+struct CoordinateBatch
+{
+    std::vector<std::string_view> names;
+    std::vector<uint32_t> lines; // 1-based line number in the buffer
+    std::vector<double> lat;
+    std::vector<double> lon;
+    std::vector<double> radius;
+    std::vector<uint8_t> hasRadius; // the radius field may be left empty
+    std::vector<BatchError> errors;
+
+    size_t size() const { return names.size(); }
+};
+
+// Parses a block of name:lat:lon:radius lines, the batchcopy format. Delimiters are
+// located 32 (AVX2) or 16 (SSE2) bytes at a time, fields are parsed straight into the
+// columns and ranges are checked over whole columns. Axes take the same decimal and
+// DMS forms as parseCoordinateText.
+CoordinateBatch parseCoordinateBatch(std::string_view buffer);
@@ -0,0 +1,263 @@
+#include "json_writer.h"
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/stat.h>
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+AtomicFile::AtomicFile(const std::string &path) : path_(path), tmpPath_(path + ".tmp")
+{
+#ifdef _WIN32
+    fd_ = _open(tmpPath_.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+    fd_ = ::open(tmpPath_.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+#endif
+}
+
+AtomicFile::~AtomicFile()
+{
+    if (fd_ >= 0)
+    {
+#ifdef _WIN32
+        _close(fd_);
+#else
+        ::close(fd_);
+#endif
+        std::remove(tmpPath_.c_str());
+    }
+}
+
+bool AtomicFile::write(const char *data, size_t size)
+{
+    while (size > 0)
+    {
+#ifdef _WIN32
+        int written = _write(fd_, data, static_cast<unsigned>(size));
+#else
+        ssize_t written = ::write(fd_, data, size);
+#endif
+        if (written <= 0)
+            return false;
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+bool AtomicFile::commit()
+{
+    if (fd_ < 0)
+        return false;
+#ifdef _WIN32
+    bool synced = _commit(fd_) == 0;
+    _close(fd_);
+    fd_ = -1;
+    if (!synced || !MoveFileExA(tmpPath_.c_str(), path_.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH))
+    {
+        std::remove(tmpPath_.c_str());
+        return false;
+    }
+#else
+    bool synced = ::fsync(fd_) == 0;
+    bool closed = ::close(fd_) == 0;
+    fd_ = -1;
+    if (!synced || !closed || std::rename(tmpPath_.c_str(), path_.c_str()) != 0)
+    {
+        std::remove(tmpPath_.c_str());
+        return false;
+    }
+#endif
+    return true;
+}
+
+JsonWriter::JsonWriter(AtomicFile &file, size_t bufferSize) : file_(file), capacity_(bufferSize)
+{
+    buffer_.reserve(capacity_);
+}
+
+void JsonWriter::put(std::string_view text)
+{
+    if (buffer_.size() + text.size() > capacity_)
+    {
+        flush();
+        if (text.size() > capacity_)
+        {
+            ok_ = ok_ && file_.write(text.data(), text.size());
+            return;
+        }
+    }
+    buffer_.append(text.data(), text.size());
+}
+
+void JsonWriter::putEscaped(std::string_view text)
+{
+    // Same escapes as nlohmann's serializer, UTF-8 is written through untouched
+    put('"');
+    size_t start = 0;
+    for (size_t i = 0; i < text.size(); i++)
+    {
+        unsigned char c = static_cast<unsigned char>(text[i]);
+        if (c >= 0x20 && c != '"' && c != '\\')
+            continue;
+        put(text.substr(start, i - start));
+        start = i + 1;
+        switch (c)
+        {
+        case '"':
+            put("\\\"");
+            break;
+        case '\\':
+            put("\\\\");
+            break;
+        case '\b':
+            put("\\b");
+            break;
+        case '\f':
+            put("\\f");
+            break;
+        case '\n':
+            put("\\n");
+            break;
+        case '\r':
+            put("\\r");
+            break;
+        case '\t':
+            put("\\t");
+            break;
+        default:
+        {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+            put(escaped);
+        }
+        }
+    }
+    put(text.substr(start));
+    put('"');
+}
+
+void JsonWriter::newline()
+{
+    put('\n');
+    for (size_t i = 0; i < levels_.size(); i++)
+        put("    ");
+}
+
+void JsonWriter::beforeValue()
+{
+    // Object members get their separator from key()
+    if (levels_.empty() || !levels_.back().isArray)
+        return;
+    if (levels_.back().count++ > 0)
+        put(',');
+    newline();
+}
+
+void JsonWriter::beginObject()
+{
+    beforeValue();
+    put('{');
+    levels_.push_back({false, 0});
+}
+
+void JsonWriter::endObject()
+{
+    bool empty = levels_.back().count == 0;
+    levels_.pop_back();
+    if (!empty)
+        newline();
+    put('}');
+}
+
+void JsonWriter::beginArray()
+{
+    beforeValue();
+    put('[');
+    levels_.push_back({true, 0});
+}
+
+void JsonWriter::endArray()
+{
+    bool empty = levels_.back().count == 0;
+    levels_.pop_back();
+    if (!empty)
+        newline();
+    put(']');
+}
+
+void JsonWriter::key(std::string_view name)
+{
+    if (levels_.back().count++ > 0)
+        put(',');
+    newline();
+    putEscaped(name);
+    put(": ");
+}
+
+void JsonWriter::value(std::string_view text)
+{
+    beforeValue();
+    putEscaped(text);
+}
+
+void JsonWriter::value(bool flag)
+{
+    beforeValue();
+    put(flag ? "true" : "false");
+}
+
+void JsonWriter::value(int64_t number)
+{
+    beforeValue();
+    char digits[24];
+    int length = std::snprintf(digits, sizeof(digits), "%lld", static_cast<long long>(number));
+    put(std::string_view(digits, static_cast<size_t>(length)));
+}
+
+void JsonWriter::value(const nlohmann::ordered_json &json)
+{
+    if (json.is_object())
+    {
+        beginObject();
+        for (auto it = json.begin(); it != json.end(); ++it)
+        {
+            key(it.key());
+            value(it.value());
+        }
+        endObject();
+    }
+    else if (json.is_array())
+    {
+        beginArray();
+        for (const auto &item : json)
+            value(item);
+        endArray();
+    }
+    else if (json.is_string())
+    {
+        value(std::string_view(json.get_ref<const std::string &>()));
+    }
+    else
+    {
+        // Numbers, booleans and null: defer to nlohmann for identical formatting
+        beforeValue();
+        put(json.dump());
+    }
+}
+
+bool JsonWriter::flush()
+{
+    if (!buffer_.empty())
+    {
+        ok_ = ok_ && file_.write(buffer_.data(), buffer_.size());
+        buffer_.clear();
+    }
+    return ok_;
+}
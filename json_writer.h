@@ -0,0 +1,77 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "nlohmann/json.hpp"
+
+// File written next to its target and renamed over it on commit, so readers only
+// ever see the old or the complete new content. Uncommitted files are removed.
+class AtomicFile
+{
+public:
+    explicit AtomicFile(const std::string &path);
+    ~AtomicFile();
+    AtomicFile(const AtomicFile &) = delete;
+    AtomicFile &operator=(const AtomicFile &) = delete;
+
+    bool isOpen() const { return fd_ >= 0; }
+    bool write(const char *data, size_t size);
+    // Flushes to disk (fsync) and renames over the target path
+    bool commit();
+
+private:
+    std::string path_;
+    std::string tmpPath_;
+    int fd_ = -1;
+};
+
+// Buffered JSON emitter producing the same text as nlohmann's dump(4), without
+// building a document first. Write errors are sticky and reported by ok().
+class JsonWriter
+{
+public:
+    explicit JsonWriter(AtomicFile &file, size_t bufferSize = 64 * 1024);
+
+    void beginObject();
+    void endObject();
+    void beginArray();
+    void endArray();
+    void key(std::string_view name);
+
+    void value(std::string_view text);
+    void value(const char *text) { value(std::string_view(text)); }
+    void value(const std::string &text) { value(std::string_view(text)); }
+    void value(bool flag);
+    void value(int64_t number);
+    void value(int number) { value(static_cast<int64_t>(number)); }
+    // Any nlohmann value, for data the writer does not model
+    void value(const nlohmann::ordered_json &json);
+
+    bool flush();
+    bool ok() const { return ok_; }
+
+private:
+    struct Level
+    {
+        bool isArray;
+        size_t count;
+    };
+
+    void beforeValue();
+    void newline();
+    void put(char c)
+    {
+        if (buffer_.size() == capacity_)
+            flush();
+        buffer_.push_back(c);
+    }
+    void put(std::string_view text);
+    void putEscaped(std::string_view text);
+
+    AtomicFile &file_;
+    std::string buffer_;
+    size_t capacity_;
+    std::vector<Level> levels_;
+    bool ok_ = true;
+};
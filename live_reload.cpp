@@ -1,120 +1,1065 @@
 #include "live_reload.h"
 #include "utils.h"
+#include <algorithm>
 #include <atomic>
-#include <thread>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
-#include <chrono>
 #include <iostream>
-#include <cstdlib>
+#include <iterator>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <zlib.h>
 
 #ifdef _WIN32
 #ifndef NOMINMAX
 #define NOMINMAX
 #endif
-#include <windows.h>
+#if !defined(_WIN32_WINNT) || _WIN32_WINNT < 0x0600
+#undef _WIN32_WINNT
+#define _WIN32_WINNT 0x0600 // WSAPoll
+#endif
+#include <winsock2.h>
+#include <ws2tcpip.h>
 #else
+#include <arpa/inet.h>
+#include <cerrno>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
 #include <unistd.h>
-#ifdef __APPLE__
-#include <mach-o/dyld.h>
+#include <poll.h>
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#endif
+#endif
+
+std::unique_ptr<LiveReloadServer> g_liveServer = nullptr;
+
+namespace
+{
+#ifdef _WIN32
+    using Socket = SOCKET;
+    constexpr Socket invalidSocket = INVALID_SOCKET;
+
+    void closeSocket(Socket socket) { closesocket(socket); }
+    bool setNonBlocking(Socket socket)
+    {
+        u_long on = 1;
+        return ioctlsocket(socket, FIONBIO, &on) == 0;
+    }
+    bool wouldBlock() { return WSAGetLastError() == WSAEWOULDBLOCK; }
+#else
+    using Socket = int;
+    constexpr Socket invalidSocket = -1;
+
+    void closeSocket(Socket socket) { ::close(socket); }
+    bool setNonBlocking(Socket socket)
+    {
+        int flags = fcntl(socket, F_GETFL, 0);
+        return flags >= 0 && fcntl(socket, F_SETFL, flags | O_NONBLOCK) == 0;
+    }
+    bool wouldBlock() { return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR; }
 #endif
+
+    // A peer that went away must not raise SIGPIPE
+#ifdef MSG_NOSIGNAL
+    constexpr int sendFlags = MSG_NOSIGNAL;
+#else
+    constexpr int sendFlags = 0;
 #endif
 
-struct Impl {
-public:
+    long sendSome(Socket socket, const char *data, size_t size)
+    {
+        return static_cast<long>(::send(socket, data, static_cast<int>(std::min<size_t>(size, 1 << 30)), sendFlags));
+    }
+
+    long receiveSome(Socket socket, char *data, size_t size)
+    {
+        return static_cast<long>(::recv(socket, data, static_cast<int>(size), 0));
+    }
+
+    // Readiness of the server sockets: epoll on Linux, poll (WSAPoll on Windows) elsewhere
+    class Poller
+    {
+    public:
+        struct Event
+        {
+            Socket socket;
+            bool readable;
+            bool writable;
+        };
+
+#ifdef __linux__
+        Poller() : fd_(epoll_create1(EPOLL_CLOEXEC)) {}
+        ~Poller()
+        {
+            if (fd_ >= 0)
+                ::close(fd_);
+        }
+        bool ok() const { return fd_ >= 0; }
+
+        void add(Socket socket) { control(EPOLL_CTL_ADD, socket, false); }
+        void setWritable(Socket socket, bool writable) { control(EPOLL_CTL_MOD, socket, writable); }
+        void remove(Socket socket) { epoll_ctl(fd_, EPOLL_CTL_DEL, socket, nullptr); }
+
+        // Blocks until a socket is ready, an interrupted wait returns nothing
+        const std::vector<Event> &wait()
+        {
+            events_.clear();
+            epoll_event ready[64];
+            int count = epoll_wait(fd_, ready, 64, -1);
+            for (int i = 0; i < count; i++)
+            {
+                // Errors and hang-ups show up as readable, the read reports them
+                bool readable = (ready[i].events & (EPOLLIN | EPOLLERR | EPOLLHUP)) != 0;
+                events_.push_back({ready[i].data.fd, readable, (ready[i].events & EPOLLOUT) != 0});
+            }
+            return events_;
+        }
+
+    private:
+        void control(int operation, Socket socket, bool writable)
+        {
+            epoll_event event{};
+            event.events = EPOLLIN | (writable ? EPOLLOUT : 0);
+            event.data.fd = socket;
+            epoll_ctl(fd_, operation, socket, &event);
+        }
+
+        int fd_;
+#else
+#ifdef _WIN32
+        using PollFd = WSAPOLLFD;
+        static int pollSockets(PollFd *fds, size_t count) { return WSAPoll(fds, static_cast<ULONG>(count), -1); }
+#else
+        using PollFd = pollfd;
+        static int pollSockets(PollFd *fds, size_t count) { return ::poll(fds, static_cast<nfds_t>(count), -1); }
+#endif
+        bool ok() const { return true; }
+
+        void add(Socket socket) { fds_.push_back({socket, POLLIN, 0}); }
+        void setWritable(Socket socket, bool writable)
+        {
+            for (PollFd &fd : fds_)
+            {
+                if (fd.fd == socket)
+                    fd.events = static_cast<short>(POLLIN | (writable ? POLLOUT : 0));
+            }
+        }
+        void remove(Socket socket)
+        {
+            fds_.erase(std::remove_if(fds_.begin(), fds_.end(), [socket](const PollFd &fd)
+                                      { return fd.fd == socket; }),
+                       fds_.end());
+        }
+
+        // Blocks until a socket is ready, an interrupted wait returns nothing
+        const std::vector<Event> &wait()
+        {
+            events_.clear();
+            if (pollSockets(fds_.data(), fds_.size()) <= 0)
+                return events_;
+            for (const PollFd &fd : fds_)
+            {
+                if (!fd.revents)
+                    continue;
+                // Errors and hang-ups show up as readable, the read reports them
+                bool readable = (fd.revents & (POLLIN | POLLERR | POLLHUP)) != 0;
+                events_.push_back({fd.fd, readable, (fd.revents & POLLOUT) != 0});
+            }
+            return events_;
+        }
+
+    private:
+        std::vector<PollFd> fds_;
+#endif
+        std::vector<Event> events_;
+    };
+
+    struct Asset
+    {
+        std::string contentType;
+        LiveReloadServer::Body body;
+        // Strong validator: a hash of the body, quoted
+        std::string etag;
+        // Compressed once when published; null when gzip would not pay off
+        LiveReloadServer::Body gzipBody;
+        std::string gzipEtag;
+    };
+
+    // Published as a whole and only ever replaced, readers take a reference and keep
+    // using their version for as long as they need it
+    using AssetTable = std::unordered_map<std::string, std::shared_ptr<const Asset>>;
+
+    struct Connection
+    {
+        std::string input;
+        // Response being sent; the next request is only read once it is out
+        std::string head;
+        LiveReloadServer::Body body;
+        size_t sent = 0;
+        bool responding = false;
+        bool closeAfter = false;
+        // Event stream: the response never ends, events are appended to head
+        bool streaming = false;
+    };
+
+    struct WatchedFile
+    {
+        std::string path;
+        std::string directory;
+        std::string name;
+        bool signalsReload;
+        bool present;
+        std::filesystem::file_time_type modified;
+    };
+
+    // Requests are GETs with a few headers, anything longer is not for this server
+    constexpr size_t maxRequestSize = 16 * 1024;
+    // Below this the gzip header and the decompression cost more than they save
+    constexpr size_t minGzipSize = 1024;
+    constexpr const char *eventsName = "events";
+
+    std::string eventFor(uint64_t signal)
+    {
+        return "data: " + std::to_string(signal) + "\n\n";
+    }
+
+    std::string contentTypeFor(const std::string &name)
+    {
+        std::string extension = std::filesystem::path(name).extension().string();
+        if (extension == ".html")
+            return "text/html; charset=utf-8";
+        if (extension == ".json")
+            return "application/json";
+        if (extension == ".js")
+            return "text/javascript";
+        if (extension == ".txt")
+            return "text/plain; charset=utf-8";
+        return "application/octet-stream";
+    }
+
+    bool readFile(const std::string &path, std::string &out)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+            return false;
+        out.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        return !file.bad();
+    }
+
+    bool equalsIgnoreCase(const std::string &a, const char *b)
+    {
+        size_t length = std::strlen(b);
+        if (a.size() != length)
+            return false;
+        for (size_t i = 0; i < length; i++)
+        {
+            if (std::tolower(static_cast<unsigned char>(a[i])) != std::tolower(static_cast<unsigned char>(b[i])))
+                return false;
+        }
+        return true;
+    }
+
+    std::string trim(const std::string &text)
+    {
+        size_t begin = text.find_first_not_of(" \t");
+        if (begin == std::string::npos)
+            return "";
+        size_t end = text.find_last_not_of(" \t");
+        return text.substr(begin, end - begin + 1);
+    }
+
+    std::string etagFor(const std::string &body)
+    {
+        // 64-bit FNV-1a and the length; collisions between two renders are not a concern
+        uint64_t hash = 14695981039346656037ull;
+        for (unsigned char c : body)
+            hash = (hash ^ c) * 1099511628211ull;
+        char etag[48];
+        std::snprintf(etag, sizeof(etag), "\"%016llx-%zx\"", static_cast<unsigned long long>(hash), body.size());
+        return etag;
+    }
+
+    // Gzip member (RFC 1952), as Content-Encoding: gzip expects; null on failure
+    LiveReloadServer::Body gzipFor(const std::string &body)
+    {
+        z_stream stream{};
+        // 15 bits of window plus 16 for the gzip header and trailer
+        if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+            return nullptr;
+        std::string out(deflateBound(&stream, static_cast<uLong>(body.size())), '\0');
+        stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(body.data()));
+        stream.avail_in = static_cast<uInt>(body.size());
+        stream.next_out = reinterpret_cast<Bytef *>(&out[0]);
+        stream.avail_out = static_cast<uInt>(out.size());
+        int result = deflate(&stream, Z_FINISH);
+        out.resize(stream.total_out);
+        deflateEnd(&stream);
+        if (result != Z_STREAM_END)
+            return nullptr;
+        return std::make_shared<const std::string>(std::move(out));
+    }
+
+    std::shared_ptr<const Asset> assetFor(const std::string &name, const LiveReloadServer::Body &body)
+    {
+        auto asset = std::make_shared<Asset>();
+        asset->contentType = contentTypeFor(name);
+        asset->body = body;
+        asset->etag = etagFor(*body);
+        if (body->size() >= minGzipSize && body->size() <= std::numeric_limits<uInt>::max())
+        {
+            LiveReloadServer::Body compressed = gzipFor(*body);
+            if (compressed && compressed->size() < body->size())
+            {
+                asset->gzipBody = std::move(compressed);
+                // Each encoding is its own representation and needs its own strong tag
+                asset->gzipEtag = asset->etag.substr(0, asset->etag.size() - 1) + "-gz\"";
+            }
+        }
+        return asset;
+    }
+
+    // Accept-Encoding lists codings with optional weights; q=0 turns one down
+    bool acceptsGzip(const std::string &header)
+    {
+        size_t position = 0;
+        while (position < header.size())
+        {
+            size_t end = header.find(',', position);
+            std::string item = header.substr(position, end == std::string::npos ? std::string::npos : end - position);
+            size_t parameters = item.find(';');
+            std::string coding = trim(item.substr(0, parameters));
+            if (equalsIgnoreCase(coding, "gzip") || equalsIgnoreCase(coding, "x-gzip") || coding == "*")
+            {
+                if (parameters == std::string::npos)
+                    return true;
+                std::string weight = trim(item.substr(parameters + 1));
+                if (weight.size() < 2 || std::tolower(static_cast<unsigned char>(weight[0])) != 'q' || weight[1] != '=')
+                    return true;
+                return std::strtod(weight.c_str() + 2, nullptr) > 0;
+            }
+            if (end == std::string::npos)
+                break;
+            position = end + 1;
+        }
+        return false;
+    }
+
+    // If-None-Match holds a list of tags (or *); weak tags compare equal to strong ones
+    bool etagMatches(const std::string &header, const std::string &etag)
+    {
+        size_t position = 0;
+        while (position < header.size())
+        {
+            size_t end = header.find(',', position);
+            std::string tag = trim(header.substr(position, end == std::string::npos ? std::string::npos : end - position));
+            if (tag.compare(0, 2, "W/") == 0)
+                tag.erase(0, 2);
+            if (tag == "*" || tag == etag)
+                return true;
+            if (end == std::string::npos)
+                break;
+            position = end + 1;
+        }
+        return false;
+    }
+}
+
+struct LiveReloadServer::Impl
+{
     std::atomic<bool> running{false};
+    int port = 0;
+    Socket listener = invalidSocket;
+    // Loopback datagram socket connected to itself; other threads send to it to wake
+    // the loop for stop() and for new signals
+    Socket waker = invalidSocket;
+    // Grows on every change of a reload file, pushed to every event stream
+    std::atomic<uint64_t> signal{0};
+    uint64_t broadcastSignal = 0;
+    Poller poller;
+    std::unordered_map<Socket, Connection> connections;
     std::thread serverThread;
+
+    // Swapped with atomic_store; publishers take the mutex to not lose each other's updates
+    std::shared_ptr<const AssetTable> assets = std::make_shared<const AssetTable>();
+    std::mutex publishMutex;
+
+    std::mutex watchMutex;
+    std::condition_variable watchWake;
+    std::vector<WatchedFile> watched;
     std::thread watchThread;
-    std::string mapFilePath;
-    std::filesystem::file_time_type lastModified;
-    int port = 4000;
+#ifdef __linux__
+    // Watches the directories of the watched files: the map files are replaced by a
+    // rename, which a watch on the file itself would not follow
+    int inotifyFd = -1;
+    // Ends the watch thread's wait in stop()
+    int watchWakeFd = -1;
+    std::unordered_map<int, std::string> directories;
+#endif
+
+    bool open(int preferredPort);
+    void closeSockets();
+    void serve();
+    void accept();
+    void receive(Socket socket);
+    void respond(Socket socket, Connection &connection);
+    void send(Socket socket, Connection &connection);
+    void drop(Socket socket);
+    void broadcast();
+    void wake();
+    std::shared_ptr<const Asset> find(const std::string &name);
+    void publish(const std::vector<std::pair<std::string, Body>> &files);
+    void signalReload();
+    // Reloads the file if it changed (or always when forced), returns whether it
+    // signals a reload
+    bool refresh(WatchedFile &file, bool force);
+    void refreshAll(bool force);
+    void watchFiles();
+    void pollFiles();
+#ifdef __linux__
+    bool openWatcher();
+    void closeWatcher();
+    void addDirectory(const std::string &directory);
+    void watchEvents();
+#endif
 };
 
-std::unique_ptr<LiveReloadServer> g_liveServer = nullptr;
+bool LiveReloadServer::Impl::open(int preferredPort)
+{
+    listener = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    waker = ::socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (listener == invalidSocket || waker == invalidSocket || !poller.ok())
+        return false;
+
+    int reuse = 1;
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char *>(&reuse), sizeof(reuse));
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(static_cast<uint16_t>(preferredPort));
+    if (::bind(listener, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0)
+    {
+        // Taken by another instance or program, let the system pick a free one
+        address.sin_port = 0;
+        if (::bind(listener, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0)
+            return false;
+    }
+    socklen_t length = sizeof(address);
+    if (::listen(listener, SOMAXCONN) != 0 || getsockname(listener, reinterpret_cast<sockaddr *>(&address), &length) != 0)
+        return false;
+    port = ntohs(address.sin_port);
 
-// single impl instance used by the wrapper methods
-static Impl impl;
+    sockaddr_in wakeAddress{};
+    wakeAddress.sin_family = AF_INET;
+    wakeAddress.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    length = sizeof(wakeAddress);
+    if (::bind(waker, reinterpret_cast<sockaddr *>(&wakeAddress), sizeof(wakeAddress)) != 0 ||
+        getsockname(waker, reinterpret_cast<sockaddr *>(&wakeAddress), &length) != 0 ||
+        ::connect(waker, reinterpret_cast<sockaddr *>(&wakeAddress), sizeof(wakeAddress)) != 0)
+        return false;
 
-LiveReloadServer::LiveReloadServer() {
+    if (!setNonBlocking(listener) || !setNonBlocking(waker))
+        return false;
+    poller.add(listener);
+    poller.add(waker);
+    return true;
 }
 
-LiveReloadServer::~LiveReloadServer() {
-    stop();
+void LiveReloadServer::Impl::closeSockets()
+{
+    for (auto &entry : connections)
+        closeSocket(entry.first);
+    connections.clear();
+    if (listener != invalidSocket)
+        closeSocket(listener);
+    if (waker != invalidSocket)
+        closeSocket(waker);
+    listener = invalidSocket;
+    waker = invalidSocket;
 }
 
-void LiveReloadServer::startServer(const std::string& mapFile) {
-    if (impl.running.load()) return;
+void LiveReloadServer::Impl::serve()
+{
+    while (running.load())
+    {
+        for (const Poller::Event &event : poller.wait())
+        {
+            if (event.socket == waker)
+            {
+                char drain[64];
+                while (receiveSome(waker, drain, sizeof(drain)) > 0)
+                {
+                }
+                broadcast();
+                continue;
+            }
+            if (event.socket == listener)
+            {
+                accept();
+                continue;
+            }
+            auto it = connections.find(event.socket);
+            if (it == connections.end())
+                continue;
+            if (event.writable)
+                send(event.socket, it->second);
+            // send may have dropped the connection
+            if (event.readable && connections.count(event.socket))
+                receive(event.socket);
+        }
+    }
+}
+
+void LiveReloadServer::Impl::accept()
+{
+    while (true)
+    {
+        Socket client = ::accept(listener, nullptr, nullptr);
+        if (client == invalidSocket)
+            return;
+        if (!setNonBlocking(client))
+        {
+            closeSocket(client);
+            continue;
+        }
+        int on = 1;
+        setsockopt(client, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char *>(&on), sizeof(on));
+#ifdef SO_NOSIGPIPE
+        setsockopt(client, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+#endif
+        connections.emplace(client, Connection());
+        poller.add(client);
+    }
+}
 
-    impl.mapFilePath = mapFile;
-    if (std::filesystem::exists(mapFile)) {
-        impl.lastModified = std::filesystem::last_write_time(mapFile);
-    } else {
-        std::cout << RED << "LiveReloadServer: Map file does not exist: " << mapFile << RESET << std::endl;
+void LiveReloadServer::Impl::receive(Socket socket)
+{
+    Connection &connection = connections[socket];
+    char buffer[16 * 1024];
+    while (true)
+    {
+        long received = receiveSome(socket, buffer, sizeof(buffer));
+        if (received > 0)
+        {
+            // Nothing is read from an event stream
+            if (!connection.streaming)
+                connection.input.append(buffer, static_cast<size_t>(received));
+            continue;
+        }
+        if (received < 0 && wouldBlock())
+            break;
+        // Closed by the peer or failed
+        drop(socket);
         return;
     }
-    impl.running.store(true);
+    respond(socket, connection);
+}
 
-    // server thread
-    impl.serverThread = std::thread([]() {
-        // Get the directory containing the map file, or use current directory if map is at root
-        std::filesystem::path mapPath(impl.mapFilePath);
-        std::filesystem::path parentDir = mapPath.parent_path();
-        std::string baseDir;
-        if (parentDir.empty()) {
-            // Map file is at root level, use current working directory
-            baseDir = std::filesystem::current_path().string();
-        } else {
-            baseDir = parentDir.string();
+void LiveReloadServer::Impl::respond(Socket socket, Connection &connection)
+{
+    if (connection.responding)
+        return;
+    size_t headerEnd = connection.input.find("\r\n\r\n");
+    if (headerEnd == std::string::npos)
+    {
+        if (connection.input.size() > maxRequestSize)
+            drop(socket);
+        return;
+    }
+    std::string request = connection.input.substr(0, headerEnd);
+    connection.input.erase(0, headerEnd + 4);
+
+    // Request line, then headers; only Connection and Content-Length matter here
+    size_t lineEnd = request.find("\r\n");
+    std::string requestLine = request.substr(0, lineEnd);
+    size_t methodEnd = requestLine.find(' ');
+    size_t targetEnd = methodEnd == std::string::npos ? std::string::npos : requestLine.find(' ', methodEnd + 1);
+    std::string method = requestLine.substr(0, methodEnd);
+    std::string target = targetEnd == std::string::npos ? "" : requestLine.substr(methodEnd + 1, targetEnd - methodEnd - 1);
+    std::string version = targetEnd == std::string::npos ? "" : requestLine.substr(targetEnd + 1);
+
+    bool keepAlive = version == "HTTP/1.1";
+    bool hasBody = false;
+    std::string ifNoneMatch;
+    bool gzip = false;
+    size_t position = lineEnd;
+    while (position != std::string::npos && position < request.size())
+    {
+        size_t next = request.find("\r\n", position + 2);
+        std::string line = request.substr(position + 2, next == std::string::npos ? std::string::npos : next - position - 2);
+        position = next;
+        size_t colon = line.find(':');
+        if (colon == std::string::npos)
+            continue;
+        std::string name = trim(line.substr(0, colon));
+        std::string value = trim(line.substr(colon + 1));
+        if (equalsIgnoreCase(name, "Connection"))
+        {
+            if (equalsIgnoreCase(value, "close"))
+                keepAlive = false;
+            else if (equalsIgnoreCase(value, "keep-alive"))
+                keepAlive = true;
         }
-#ifdef _WIN32
-        std::string command = "cd \"" + baseDir + "\" && py -m http.server " + std::to_string(impl.port) + " 2>nul";
-#else
-        std::string command = "cd \"" + baseDir + "\" && python -m http.server " + std::to_string(impl.port) + " 2>nul";
-#endif
-        std::system(command.c_str());
-    });
-
-    // watch thread
-    impl.watchThread = std::thread([]() {
-        while (impl.running.load()) {
-            if (!impl.mapFilePath.empty() && std::filesystem::exists(impl.mapFilePath)) {
-                auto currentModified = std::filesystem::last_write_time(impl.mapFilePath);
-                if (currentModified > impl.lastModified) {
-                    impl.lastModified = currentModified;
-                    // Get the directory containing the map file, or use current directory if map is at root
-                    std::filesystem::path mapPath(impl.mapFilePath);
-                    std::filesystem::path parentDir = mapPath.parent_path();
-                    // If parent_path is empty, use current directory
-                    if (parentDir.empty()) {
-                        parentDir = ".";
-                    }
-                    std::string signalFile = parentDir.string() + "/reload_signal.txt";
-                    std::ofstream signal(signalFile);
-                    if (signal) {
-                        signal << std::chrono::duration_cast<std::chrono::milliseconds>(
-                            std::chrono::system_clock::now().time_since_epoch()).count();
-                        signal.close();
-                    }
+        else if (equalsIgnoreCase(name, "If-None-Match"))
+        {
+            ifNoneMatch = value;
+        }
+        else if (equalsIgnoreCase(name, "Accept-Encoding"))
+        {
+            gzip = acceptsGzip(value);
+        }
+        else if ((equalsIgnoreCase(name, "Content-Length") && value != "0") || equalsIgnoreCase(name, "Transfer-Encoding"))
+        {
+            hasBody = true;
+        }
+    }
+
+    std::string status = "200 OK";
+    std::shared_ptr<const Asset> asset;
+    if (version.compare(0, 5, "HTTP/") != 0 || target.empty() || target[0] != '/')
+    {
+        status = "400 Bad Request";
+        keepAlive = false;
+    }
+    else if ((method != "GET" && method != "HEAD") || hasBody)
+    {
+        // Nothing here takes a body, so the stream cannot be resynchronized after one
+        status = "405 Method Not Allowed";
+        keepAlive = false;
+    }
+    else
+    {
+        size_t query = target.find('?');
+        std::string name = target.substr(1, query == std::string::npos ? std::string::npos : query - 1);
+        if (name == eventsName && method == "GET")
+        {
+            // Ended by the peer only; the current signal goes out first so a reconnecting
+            // page sees what it missed
+            broadcastSignal = std::max(broadcastSignal, signal.load());
+            connection.head = "HTTP/1.1 200 OK\r\nContent-Type: text/event-stream\r\nCache-Control: no-cache\r\n\r\n";
+            connection.head += "retry: 1000\n" + eventFor(broadcastSignal);
+            connection.body = nullptr;
+            connection.sent = 0;
+            connection.responding = true;
+            connection.streaming = true;
+            send(socket, connection);
+            return;
+        }
+        asset = find(name);
+        if (!asset)
+            status = "404 Not Found";
+        else if (!ifNoneMatch.empty() && etagMatches(ifNoneMatch, gzip && asset->gzipBody ? asset->gzipEtag : asset->etag))
+            status = "304 Not Modified";
+    }
+    gzip = gzip && asset && asset->gzipBody;
+    const LiveReloadServer::Body *body = asset ? (gzip ? &asset->gzipBody : &asset->body) : nullptr;
+
+    bool sendBody = status == "200 OK" && method != "HEAD";
+    connection.head = "HTTP/1.1 " + status + "\r\n";
+    if (asset)
+    {
+        connection.head += "Content-Type: " + asset->contentType + "\r\n";
+        connection.head += "ETag: " + (gzip ? asset->gzipEtag : asset->etag) + "\r\n";
+        if (asset->gzipBody)
+            connection.head += "Vary: Accept-Encoding\r\n";
+        if (gzip && status != "304 Not Modified")
+            connection.head += "Content-Encoding: gzip\r\n";
+    }
+    // A 304 has no body and no length; a HEAD gets the length of what a GET would send
+    if (status != "304 Not Modified")
+        connection.head += "Content-Length: " + std::to_string(body ? (*body)->size() : 0) + "\r\n";
+    // Cached copies are revalidated on every use, the ETag makes that cheap
+    connection.head += "Cache-Control: no-cache\r\n";
+    if (!keepAlive)
+        connection.head += "Connection: close\r\n";
+    connection.head += "\r\n";
+    connection.body = sendBody ? *body : nullptr;
+    connection.sent = 0;
+    connection.responding = true;
+    connection.closeAfter = !keepAlive;
+    send(socket, connection);
+}
+
+void LiveReloadServer::Impl::send(Socket socket, Connection &connection)
+{
+    if (!connection.responding)
+        return;
+    size_t total = connection.head.size() + (connection.body ? connection.body->size() : 0);
+    while (connection.sent < total)
+    {
+        bool inHead = connection.sent < connection.head.size();
+        const char *data = inHead ? connection.head.data() + connection.sent : connection.body->data() + (connection.sent - connection.head.size());
+        size_t size = inHead ? connection.head.size() - connection.sent : total - connection.sent;
+        long written = sendSome(socket, data, size);
+        if (written < 0 && wouldBlock())
+        {
+            // Resumed once the socket drains
+            poller.setWritable(socket, true);
+            return;
+        }
+        if (written <= 0)
+        {
+            drop(socket);
+            return;
+        }
+        connection.sent += static_cast<size_t>(written);
+    }
+
+    if (connection.closeAfter)
+    {
+        drop(socket);
+        return;
+    }
+    if (connection.streaming)
+    {
+        connection.head.clear();
+        connection.sent = 0;
+        poller.setWritable(socket, false);
+        return;
+    }
+    connection.responding = false;
+    connection.body.reset();
+    connection.head.clear();
+    poller.setWritable(socket, false);
+    // A pipelined request may already be waiting
+    respond(socket, connection);
+}
+
+void LiveReloadServer::Impl::drop(Socket socket)
+{
+    poller.remove(socket);
+    closeSocket(socket);
+    connections.erase(socket);
+}
+
+void LiveReloadServer::Impl::broadcast()
+{
+    uint64_t current = signal.load();
+    if (current == broadcastSignal)
+        return;
+    broadcastSignal = current;
+    std::string event = eventFor(current);
+    // send may drop connections, so the streams are collected first
+    std::vector<Socket> streams;
+    for (const auto &entry : connections)
+    {
+        if (entry.second.streaming)
+            streams.push_back(entry.first);
+    }
+    for (Socket socket : streams)
+    {
+        Connection &connection = connections[socket];
+        bool idle = connection.head.empty();
+        connection.head += event;
+        // A stream still draining the previous event picks this one up when writable
+        if (idle)
+            send(socket, connection);
+    }
+}
+
+void LiveReloadServer::Impl::wake()
+{
+    char byte = 1;
+    sendSome(waker, &byte, 1);
+}
+
+std::shared_ptr<const Asset> LiveReloadServer::Impl::find(const std::string &name)
+{
+    std::shared_ptr<const AssetTable> table = std::atomic_load(&assets);
+    auto it = table->find(name);
+    return it == table->end() ? nullptr : it->second;
+}
+
+void LiveReloadServer::Impl::publish(const std::vector<std::pair<std::string, Body>> &files)
+{
+    // Hashed and compressed on the publishing thread before the lock, so each version
+    // is compressed once and the server thread never waits for it. A body published
+    // again as is (the page, on every render) keeps its asset.
+    std::vector<std::shared_ptr<const Asset>> published;
+    for (const auto &file : files)
+    {
+        std::shared_ptr<const Asset> current = find(file.first);
+        published.push_back(current && current->body == file.second ? current : assetFor(file.first, file.second));
+    }
+
+    std::lock_guard<std::mutex> lock(publishMutex);
+    auto table = std::make_shared<AssetTable>(*std::atomic_load(&assets));
+    for (size_t i = 0; i < files.size(); i++)
+        (*table)[files[i].first] = published[i];
+    std::atomic_store(&assets, std::shared_ptr<const AssetTable>(std::move(table)));
+}
+
+void LiveReloadServer::Impl::signalReload()
+{
+    // Milliseconds since the epoch, so a page that outlives a restart still sees it grow
+    uint64_t now = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count());
+    uint64_t previous = signal.load();
+    while (!signal.compare_exchange_weak(previous, std::max(now, previous + 1)))
+    {
+    }
+    if (running.load())
+        wake();
+}
+
+bool LiveReloadServer::Impl::refresh(WatchedFile &file, bool force)
+{
+    std::error_code error;
+    auto modified = std::filesystem::last_write_time(file.path, error);
+    if (error || (!force && file.present && modified == file.modified))
+        return false;
+    std::string body;
+    if (!readFile(file.path, body))
+        return false;
+    file.present = true;
+    file.modified = modified;
+    // Renders publish what they write, the watcher then reads the same content back
+    std::shared_ptr<const Asset> current = find(file.name);
+    if (current && *current->body == body)
+        return false;
+    publish({{file.name, std::make_shared<const std::string>(std::move(body))}});
+    return file.signalsReload;
+}
+
+void LiveReloadServer::Impl::refreshAll(bool force)
+{
+    bool changed = false;
+    for (WatchedFile &file : watched)
+        changed = refresh(file, force) || changed;
+    if (changed)
+        signalReload();
+}
+
+void LiveReloadServer::Impl::watchFiles()
+{
+#ifdef __linux__
+    if (inotifyFd >= 0)
+    {
+        watchEvents();
+        return;
+    }
+#endif
+    pollFiles();
+}
+
+void LiveReloadServer::Impl::pollFiles()
+{
+    // Without change notifications, the modification times are checked twice a second
+    std::unique_lock<std::mutex> lock(watchMutex);
+    while (running.load())
+    {
+        watchWake.wait_for(lock, std::chrono::milliseconds(500));
+        if (running.load())
+            refreshAll(false);
+    }
+}
+
+#ifdef __linux__
+bool LiveReloadServer::Impl::openWatcher()
+{
+    inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    watchWakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (inotifyFd >= 0 && watchWakeFd >= 0)
+        return true;
+    closeWatcher();
+    return false;
+}
+
+void LiveReloadServer::Impl::closeWatcher()
+{
+    if (inotifyFd >= 0)
+        ::close(inotifyFd);
+    if (watchWakeFd >= 0)
+        ::close(watchWakeFd);
+    inotifyFd = -1;
+    watchWakeFd = -1;
+    directories.clear();
+}
+
+void LiveReloadServer::Impl::addDirectory(const std::string &directory)
+{
+    if (inotifyFd < 0)
+        return;
+    for (const auto &entry : directories)
+    {
+        if (entry.second == directory)
+            return;
+    }
+    int wd = inotify_add_watch(inotifyFd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+    if (wd >= 0)
+        directories[wd] = directory;
+}
+
+void LiveReloadServer::Impl::watchEvents()
+{
+    // A render replaces several files in a row; events are collected until the
+    // directory has been quiet for this long and then handled in one go
+    constexpr int quietMs = 20;
+    alignas(inotify_event) char buffer[16 * 1024];
+    std::vector<std::string> changed;
+    pollfd fds[2] = {{inotifyFd, POLLIN, 0}, {watchWakeFd, POLLIN, 0}};
+    while (running.load())
+    {
+        int ready = ::poll(fds, 2, changed.empty() ? -1 : quietMs);
+        if (!running.load())
+            break;
+        if (ready < 0)
+            continue;
+        if (ready == 0)
+        {
+            std::lock_guard<std::mutex> lock(watchMutex);
+            bool signal = false;
+            for (WatchedFile &file : watched)
+            {
+                if (std::find(changed.begin(), changed.end(), file.directory + "/" + file.name) != changed.end())
+                    signal = refresh(file, true) || signal;
+            }
+            if (signal)
+                signalReload();
+            changed.clear();
+            continue;
+        }
+
+        long length;
+        while ((length = ::read(inotifyFd, buffer, sizeof(buffer))) > 0)
+        {
+            std::lock_guard<std::mutex> lock(watchMutex);
+            for (char *p = buffer; p < buffer + length;)
+            {
+                const inotify_event *event = reinterpret_cast<const inotify_event *>(p);
+                p += sizeof(inotify_event) + event->len;
+                auto directory = directories.find(event->wd);
+                if (event->len == 0 || directory == directories.end())
+                    continue;
+                std::string key = directory->second + "/" + event->name;
+                for (const WatchedFile &file : watched)
+                {
+                    if (file.directory + "/" + file.name == key && std::find(changed.begin(), changed.end(), key) == changed.end())
+                        changed.push_back(key);
                 }
             }
-            std::this_thread::sleep_for(std::chrono::milliseconds(500));
         }
-    });
+    }
+}
+#endif
+
+LiveReloadServer::LiveReloadServer() : impl_(std::make_unique<Impl>())
+{
+}
 
-    std::cout << GREEN << "Live reload server started at http://localhost:" << impl.port << RESET << std::endl;
+LiveReloadServer::~LiveReloadServer()
+{
+    stop();
 }
 
-void LiveReloadServer::stop() {
-    if (!impl.running.load()) return;
-    impl.running.store(false);
-    if (impl.watchThread.joinable()) impl.watchThread.join();
-    // serverThread runs python -m http.server which blocks; we cannot forcibly kill it portably here.
-    // Leaving it detached is acceptable; it will terminate when process exits.
-    if (impl.serverThread.joinable()) {
-        impl.serverThread.detach();
+bool LiveReloadServer::start(int preferredPort)
+{
+    if (impl_->running.load())
+        return true;
+#ifdef _WIN32
+    WSADATA data;
+    if (WSAStartup(MAKEWORD(2, 2), &data) != 0)
+        return false;
+#endif
+    if (!impl_->open(preferredPort))
+    {
+        impl_->closeSockets();
+#ifdef _WIN32
+        WSACleanup();
+#endif
+        return false;
+    }
+#ifdef __linux__
+    // Falls back to polling if change notifications are not available
+    if (impl_->openWatcher())
+    {
+        std::lock_guard<std::mutex> lock(impl_->watchMutex);
+        for (const WatchedFile &file : impl_->watched)
+            impl_->addDirectory(file.directory);
     }
+#endif
+    impl_->signalReload();
+    impl_->running.store(true);
+    impl_->serverThread = std::thread([this]
+                                      { impl_->serve(); });
+    impl_->watchThread = std::thread([this]
+                                     { impl_->watchFiles(); });
+    return true;
+}
+
+void LiveReloadServer::watch(const std::string &path, bool signalsReload)
+{
+    std::lock_guard<std::mutex> lock(impl_->watchMutex);
+    for (const WatchedFile &file : impl_->watched)
+    {
+        if (file.path == path)
+            return;
+    }
+    std::filesystem::path filePath(path);
+    std::string directory = filePath.parent_path().empty() ? "." : filePath.parent_path().string();
+    WatchedFile file{path, directory, filePath.filename().string(), signalsReload, false, {}};
+    // Served right away, later changes are picked up by the watch thread
+    impl_->refresh(file, false);
+    impl_->watched.push_back(std::move(file));
+#ifdef __linux__
+    impl_->addDirectory(directory);
+#endif
+}
+
+void LiveReloadServer::stop()
+{
+    if (!impl_->running.exchange(false))
+        return;
+    impl_->wake();
+    {
+        // Taken so the watch thread is either waiting or about to see running go false
+        std::lock_guard<std::mutex> lock(impl_->watchMutex);
+    }
+    impl_->watchWake.notify_all();
+#ifdef __linux__
+    if (impl_->watchWakeFd >= 0)
+    {
+        uint64_t one = 1;
+        [[maybe_unused]] ssize_t written = ::write(impl_->watchWakeFd, &one, sizeof(one));
+    }
+#endif
+    impl_->serverThread.join();
+    impl_->watchThread.join();
+    impl_->closeSockets();
+#ifdef __linux__
+    impl_->closeWatcher();
+#endif
+#ifdef _WIN32
+    WSACleanup();
+#endif
+}
+
+void LiveReloadServer::publish(const std::vector<std::pair<std::string, Body>> &files, bool signalReload)
+{
+    impl_->publish(files);
+    if (signalReload)
+        impl_->signalReload();
+}
+
+bool LiveReloadServer::running() const
+{
+    return impl_->running.load();
 }
 
-int LiveReloadServer::getPort() const {
-    return impl.port;
+int LiveReloadServer::getPort() const
+{
+    return impl_->port;
 }
@@ -1,16 +1,43 @@
 #pragma once
-#include <string>
 #include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 
 class LiveReloadServer;
 
 extern std::unique_ptr<LiveReloadServer> g_liveServer;
 
-class LiveReloadServer {
+// In-process HTTP/1.1 server for the debug map. It serves published buffers and
+// watched files, both from memory and with strong ETags; nothing else is served.
+class LiveReloadServer
+{
 public:
+    // Immutable once published; requests in flight keep the version they started with
+    using Body = std::shared_ptr<const std::string>;
+
     LiveReloadServer();
+    // Stops the server if it is still running
     ~LiveReloadServer();
-    void startServer(const std::string& mapFile);
+    LiveReloadServer(const LiveReloadServer &) = delete;
+    LiveReloadServer &operator=(const LiveReloadServer &) = delete;
+
+    // Listens on localhost, on preferredPort when it is free and on a port picked by
+    // the system otherwise. Requests are accepted as soon as this returns true.
+    bool start(int preferredPort = 4000);
+    // Serves the file as /<file name>, reread whenever it changes on disk. A change to a
+    // file watched with signalsReload is pushed to the open map pages through the
+    // /events stream (Server-Sent Events).
+    void watch(const std::string &path, bool signalsReload);
+    // Serves each body as /<name> from now on. All files of one call are swapped in
+    // at once; signalReload pushes the change to the open pages.
+    void publish(const std::vector<std::pair<std::string, Body>> &files, bool signalReload);
+    // Closes every connection and joins the server threads
     void stop();
+    bool running() const;
     int getPort() const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
 };
@@ -1,12 +1,21 @@
 #include "map_generator.h"
+#include "json_writer.h"
 #include "live_reload.h"
 #include "utils.h"
+#include <cstdio>
 #include <filesystem>
-#include <fstream>
 #include <iostream>
 #include <chrono>
-#include <thread>
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <string_view>
+#include <unordered_map>
 #ifdef _WIN32
 #ifndef NOMINMAX
 #define NOMINMAX
@@ -14,82 +23,15 @@
 #include <windows.h>
 #endif
 
-void generateMap(const nlohmann::ordered_json &configJson, const std::string &icao, bool openBrowser)
+namespace
 {
-    std::string filename = icao + "_map.html";
-    std::ofstream htmlFile(filename);
-
-    if (!htmlFile)
-    {
-        std::cout << RED << "Error creating HTML file." << RESET << std::endl;
-        return;
-    }
-
-    // Calculate bounds from all stands so we can fit the map to show them all
-    double totalLat = 0, totalLon = 0;
-    double centerLat = 0, centerLon = 0;
-    int zoomLevel = 6;
-    int validStands = 0;
-    double minLat = 1e9, maxLat = -1e9, minLon = 1e9, maxLon = -1e9;
-    double firstLat = 0, firstLon = 0;
-
-    if (!configJson.contains("Stands") || !configJson["Stands"].is_object())
-    {
-        centerLat = 47.009279;
-        centerLon = 3.765732;
-    }
-    else
-    {
-        for (auto &[standName, standData] : configJson["Stands"].items())
-        {
-            if (standData.contains("Coordinates"))
-            {
-                std::string coords = standData["Coordinates"];
-                size_t firstColon = coords.find(':');
-                size_t secondColon = coords.find(':', firstColon + 1);
-                if (firstColon != std::string::npos && secondColon != std::string::npos)
-                {
-                    try
-                    {
-                        double lat = std::stod(coords.substr(0, firstColon));
-                        double lon = std::stod(coords.substr(firstColon + 1, secondColon - firstColon - 1));
-                        totalLat += lat;
-                        totalLon += lon;
-                        // update bounds
-                        if (lat < minLat)
-                            minLat = lat;
-                        if (lat > maxLat)
-                            maxLat = lat;
-                        if (lon < minLon)
-                            minLon = lon;
-                        if (lon > maxLon)
-                            maxLon = lon;
-                        if (validStands == 0)
-                        {
-                            firstLat = lat;
-                            firstLon = lon;
-                        }
-                        validStands++;
-                    }
-                    catch (...)
-                    { /* Skip invalid coordinates */
-                    }
-                }
-            }
-        }
-
-        centerLat = validStands > 0 ? totalLat / validStands : 47.009279;
-        centerLon = validStands > 0 ? totalLon / validStands : 3.765732;
-        // (Stand JS generation moved into the HTML <script> block below.)
-        // Generate timestamp for JavaScript use
-        auto now = std::chrono::system_clock::now();
-        auto timestamp = std::chrono::duration_cast<std::chrono::seconds>(now.time_since_epoch()).count();
-
-        htmlFile << R"(<!DOCTYPE html>
+    // Page before the data block; the title is the only dynamic part
+    constexpr const char *pageHead = R"(<!DOCTYPE html>
 <html>
 <head>
-    <title>)" << icao
-                 << R"( - Airport Stands Debug Map</title>
+    <title>)";
+
+    constexpr const char *pageStyle = R"( - Airport Stands Debug Map</title>
     <meta charset="utf-8" />
     <meta name="viewport" content="width=device-width, initial-scale=1.0">
     <link rel="stylesheet" href="https://unpkg.com/leaflet@1.9.4/dist/leaflet.css" />
@@ -102,23 +44,25 @@ void generateMap(const nlohmann::ordered_json &configJson, const std::string &ic
             border-radius: 5px; 
             box-shadow: 0 2px 5px rgba(0,0,0,0.2);
         }
+        .stand-label div { background-color: rgba(255,255,255,0.8); padding: 2px 4px; border-radius: 3px; font-weight: bold; font-size: 12px; color: black; text-align: center; display: flex; align-items: center; justify-content: center; width: 100%; height: 100%; box-sizing: border-box; }
     </style>
 </head>
 <body>
     <div id="map"></div>
     <script src="https://unpkg.com/leaflet@1.9.4/dist/leaflet.js"></script>
     <script>
+)";
+
+    // Everything the page does with the stands data; identical for every airport
+    constexpr const char *pageScript = R"(
         // Restore saved map position and zoom, or use defaults
         var savedCenter = localStorage.getItem('mapCenter');
         var savedZoom = localStorage.getItem('mapZoom');
         var filter = localStorage.getItem('standFilter');
 
-        var initialLat = savedCenter ? JSON.parse(savedCenter).lat : )"
-                 << centerLat << R"(;
-        var initialLng = savedCenter ? JSON.parse(savedCenter).lng : )"
-                 << centerLon << R"(;
-        var initialZoom = savedZoom ? parseInt(savedZoom) : )"
-                 << zoomLevel << R"(;
+        var initialLat = savedCenter ? JSON.parse(savedCenter).lat : 47.009279;
+        var initialLng = savedCenter ? JSON.parse(savedCenter).lng : 3.765732;
+        var initialZoom = savedZoom ? parseInt(savedZoom) : 6;
         
         var map = L.map('map', {
             maxZoom: 19  // Increase maximum zoom level
@@ -134,17 +78,16 @@ void generateMap(const nlohmann::ordered_json &configJson, const std::string &ic
         // Save state on move and zoom events
         map.on('moveend', saveMapState);
         map.on('zoomend', saveMapState);
+        // Each zoom has its own set of labels
+        map.on('zoomend', function() {
+            if (standLayer) standLayer.labelsChanged();
+        });
         
-        // Flag to track if reload is intentional (auto-reload vs page close)
-        var isAutoReloading = false;
-        
-        // Clear localStorage when page is closed (but not on auto-reload)
+        // Clear localStorage when page is closed, edits are applied without reloading
         window.addEventListener('beforeunload', function(e) {
-            if (!isAutoReloading) {
-                localStorage.removeItem('mapCenter');
-                localStorage.removeItem('mapZoom');
-                // Keep standFilter for color mode persistence
-            }
+            localStorage.removeItem('mapCenter');
+            localStorage.removeItem('mapZoom');
+            // Keep standFilter for color mode persistence
         });
         
         // Add satellite tile layer
@@ -153,307 +96,588 @@ void generateMap(const nlohmann::ordered_json &configJson, const std::string &ic
             maxZoom: 19  // Set tile layer max zoom
         }).addTo(map);
         
-        // Store references to current stands for cleanup
-        var currentStandElements = [];
+        // Drawn stands, by name for delta updates and as a list for coloring
+        var standsByName = {};
+        var standItems = [];
+        // Render the drawn stands come from, deltas only apply on top of it
+        var standSession = null;
+        var standRevision = null;
+        // Colors of each mode of the color panel, with how many stands have them;
+        // rows point into these by index (row[15], in COLOR_MODES order)
+        var COLOR_MODES = ['default', 'schengen', 'apron', 'use', 'priority', 'codeHighest', 'codeAll', 'remark', 'wingspan', 'callsign'];
+        var standPalettes = null;
+        // Labels to draw per zoom, worked out with the render so overlapping ones are
+        // left out without any collision work here: {from, full, sets}, where sets[i]
+        // is a base64 bitset over label slots (row[16]) for zoom from + i
+        var standLabels = null;
+        var labelBits = [];
+
+        function setLabels(labels) {
+            standLabels = labels;
+            labelBits = [];
+        }
+
+        function labelShown(item) {
+            var zoom = Math.floor(map.getZoom());
+            // No sets when every label fits from the first zoom on
+            if (!standLabels || zoom >= standLabels.full || !standLabels.sets.length) return true;
+            var index = Math.min(Math.max(zoom - standLabels.from, 0), standLabels.sets.length - 1);
+            if (!labelBits[index]) {
+                var text = atob(standLabels.sets[index]);
+                var bits = new Uint8Array(text.length);
+                for (var i = 0; i < text.length; i++) bits[i] = text.charCodeAt(i);
+                labelBits[index] = bits;
+            }
+            var slot = item.row[16];
+            return (labelBits[index][slot >> 3] & (1 << (slot & 7))) !== 0;
+        }
         
         // Color function for different stand types
         function getStandColor(standData) {
             return '#96CEB4';  // Green for default
         }
-)";
 
-        // Add stands to the map
-        if (configJson.contains("Stands") && configJson["Stands"].is_object())
-        {
-            for (auto &[standName, standData] : configJson["Stands"].items())
-            {
-                if (standData.contains("Coordinates"))
-                {
-                    std::string coords = standData["Coordinates"];
-                    size_t firstColon = coords.find(':');
-                    size_t secondColon = coords.find(':', firstColon + 1);
-                    if (firstColon != std::string::npos && secondColon != std::string::npos)
-                    {
-                        try
-                        {
-                            double lat = std::stod(coords.substr(0, firstColon));
-                            double lon = std::stod(coords.substr(firstColon + 1, secondColon - firstColon - 1));
-                            std::string radiusStr = coords.substr(secondColon + 1);
-                            double radius = radiusStr.empty() ? 20 : std::stod(radiusStr);
-                            std::string standNameVar = standName;
-                            std::replace(standNameVar.begin(), standNameVar.end(), ' ', '_');
-
-                            htmlFile << "        // Stand " << standName << "\n";
-                            htmlFile << "        var stand_" << standNameVar << " = {\n";
-                            htmlFile << "            name: '" << standName << "',\n";
-                            htmlFile << "            lat: " << lat << ",\n";
-                            htmlFile << "            lon: " << lon << ",\n";
-                            htmlFile << "            radius: " << radius << ",\n";
-                            if (standData.contains("Code"))
-                                htmlFile << "            Code: '" << standData["Code"] << "',\n";
-                            if (standData.contains("Use"))
-                                htmlFile << "            Use: '" << standData["Use"] << "',\n";
-                            if (standData.contains("Schengen"))
-                                htmlFile << "            Schengen: " << (standData["Schengen"].get<bool>() ? "true" : "false") << ",\n";
-                            // Safely emit Apron flag: if Apron is boolean use it, if it's an object (with Coordinates) emit true
-                            if (standData.contains("Apron")) {
-                                if (standData["Apron"].is_boolean())
-                                    htmlFile << "            Apron: " << (standData["Apron"].get<bool>() ? "true" : "false") << ",\n";
-                                else
-                                    htmlFile << "            Apron: true,\n";
-                            }
-                            if (standData.contains("Remark"))
-                                htmlFile << "            Remark: '" << standData["Remark"] << "',\n";
-                            if (standData.contains("Wingspan"))
-                                htmlFile << "            Wingspan: '" << standData["Wingspan"] << "',\n";
-                            if (standData.contains("Callsigns"))
-                                htmlFile << "            Callsigns: '" << standData["Callsigns"] << "',\n";
-                            if (standData.contains("Priority"))
-                                htmlFile << "            Priority: " << standData["Priority"] << ",\n";
-                            htmlFile << "        };\n";
-                            
-                            // If apron and coordinates defined, draw polygon from coordinates
-                            if (standData.contains("Apron") && standData["Apron"].contains("Coordinates"))
-                            {
-                                // define polygon
-                                htmlFile << "        var apronCoords_" << standNameVar << " = [\n";
-
-                                for (const auto &coord : standData["Apron"]["Coordinates"].get<std::vector<std::string>>())
-                                {
-                                    std::string coords = coord;
-                                    size_t firstColon = coords.find(':');
-                                    if (firstColon != std::string::npos) {
-                                        double latA = std::stod(coords.substr(0, firstColon));
-                                        double lonA = std::stod(coords.substr(firstColon + 1));
-                                        htmlFile << "            [" << latA << ", " << lonA << "],\n";
-                                    }
-                                }
-                                htmlFile << "        ];\n";
-                                htmlFile << "        var symbol_" << standNameVar << " = L.polygon(apronCoords_" << standNameVar << ", {\n";
-                                htmlFile << "            color: getStandColor(stand_" << standNameVar << "),\n";
-                                htmlFile << "            fillColor: getStandColor(stand_" << standNameVar << "),\n";
-                                htmlFile << "            fillOpacity: 0.4\n";
-                                htmlFile << "        }).addTo(map);\n";
-                            }
-                            else
-                            {
-                                // create circle named "symbol_<name>" (fix typo from 'simbol_')
-                                htmlFile << "        var symbol_" << standNameVar << " = L.circle([" << lat << ", " << lon << "], {\n";
-                                htmlFile << "            radius: " << radius << ",\n";
-                                htmlFile << "            color: getStandColor(stand_" << standNameVar << "),\n";
-                                htmlFile << "            fillColor: getStandColor(stand_" << standNameVar << "),\n";
-                                htmlFile << "            fillOpacity: 0.4\n";
-                                htmlFile << "        }).addTo(map);\n";
-                            }
+        function escapeHtml(text) {
+            return String(text).replace(/[&<>"']/g, function(c) {
+                return {'&': '&amp;', '<': '&lt;', '>': '&gt;', '"': '&quot;', "'": '&#39;'}[c];
+            });
+        }
 
-                            htmlFile << "        currentStandElements.push(symbol_" << standNameVar << ");\n";
-                            
-                            // Helper: escape string for JS single-quoted literal
-                            auto escape_js = [](const std::string &s) {
-                                std::string out;
-                                out.reserve(s.size());
-                                for (char c : s) {
-                                    if (c == '\\') out += "\\\\";
-                                    else if (c == '\'') out += "\\\'";
-                                    else if (c == '\n') out += "\\n";
-                                    else if (c == '\r') continue;
-                                    else out += c;
-                                }
-                                return out;
-                            };
-
-                            // Build popup content with safe string extraction (avoid json operator<< which emits quotes/objects)
-                            std::string popupVar = "popupContent_" + standNameVar;
-                            htmlFile << "        var " << popupVar << " = '<div class=\"stand-info\">Stand: " << escape_js(standName) << "</div>';\n";
-
-                            if (standData.contains("Code") && standData["Code"].is_string()) {
-                                htmlFile << "        " << popupVar << " += '<br>Code: " << escape_js(standData["Code"].get<std::string>()) << "';\n";
-                            }
-                            if (standData.contains("Use") && standData["Use"].is_string()) {
-                                htmlFile << "        " << popupVar << " += '<br>Use: " << escape_js(standData["Use"].get<std::string>()) << "';\n";
-                            }
-                            if (standData.contains("Schengen") && standData["Schengen"].is_boolean()) {
-                                htmlFile << "        " << popupVar << " += '<br>Schengen: " << (standData["Schengen"].get<bool>() ? "Yes" : "No") << "';\n";
-                            }
-                            // Apron may be boolean or object -> treat object as Yes
-                            if (standData.contains("Apron")) {
-                                if (standData["Apron"].is_boolean())
-                                    htmlFile << "        " << popupVar << " += '<br>Apron: " << (standData["Apron"].get<bool>() ? "Yes" : "No") << "';\n";
-                                else
-                                    htmlFile << "        " << popupVar << " += '<br>Apron: Yes';\n";
-                            }
-                            if (standData.contains("Wingspan")) {
-                                if (standData["Wingspan"].is_number())
-                                    htmlFile << "        " << popupVar << " += '<br>Wingspan: " << standData["Wingspan"].get<double>() << "m';\n";
-                                else if (standData["Wingspan"].is_string())
-                                    htmlFile << "        " << popupVar << " += '<br>Wingspan: " << escape_js(standData["Wingspan"].get<std::string>()) << "m';\n";
-                            }
-                            if (standData.contains("Remark") && standData["Remark"].is_object()) {
-                                for (const auto &it : standData["Remark"].items()) {
-                                    htmlFile << "        " << popupVar << " += '<br>Remark (" << escape_js(it.key()) << "): " << escape_js(it.value().is_string() ? it.value().get<std::string>() : it.value().dump()) << "';\n";
-                                }
-                            }
-                            if (standData.contains("Priority")) {
-                                htmlFile << "        " << popupVar << " += '<br>Priority: " << standData["Priority"] << "';\n";
-                            }
-                            htmlFile << "        " << popupVar << " += '<br>Radius: " << radius << "m';\n";
-                            htmlFile << "        " << popupVar << " += '<br>Coordinates: " << escape_js(coords) << "';\n";
-
-                            // arrays: Callsigns / Countries / Block
-                            auto emit_array_as_text = [&](const std::string &field, const std::string &label) {
-                                if (standData.contains(field) && standData[field].is_array()) {
-                                    htmlFile << "        " << popupVar << " += '<br>" << label << ": ";
-                                    bool first = true;
-                                    for (const auto &v : standData[field]) {
-                                        if (!first) htmlFile << ", ";
-                                        first = false;
-                                        if (v.is_string())
-                                            htmlFile << escape_js(v.get<std::string>());
-                                        else
-                                            htmlFile << escape_js(v.dump());
-                                    }
-                                    htmlFile << "';\n";
-                                }
-                            };
-                            emit_array_as_text("Callsigns", "Callsigns");
-                            emit_array_as_text("Countries", "Countries");
-                            emit_array_as_text("Block", "Blocked");
-
-                            htmlFile << "        symbol_" << standNameVar << ".bindPopup(" << popupVar << ");\n";
-
-                            // Add click event to symbol for coordinate copying
-                            htmlFile << "        symbol_" << standNameVar << ".on('click', function(e) {\n";
-                            htmlFile << "            var lat = e.latlng.lat.toFixed(6);\n";
-                            htmlFile << "            var lng = e.latlng.lng.toFixed(6);\n";
-                            htmlFile << "            var coordString = lat + ':' + lng;\n";
-                            htmlFile << "            \n";
-                            htmlFile << "            // Copy to clipboard\n";
-                            htmlFile << "            if (navigator.clipboard && window.isSecureContext) {\n";
-                            htmlFile << "                navigator.clipboard.writeText(coordString).then(function() {\n";
-                            htmlFile << "                    console.log('Coordinates copied: ' + coordString);\n";
-                            htmlFile << "                }).catch(function(err) {\n";
-                            htmlFile << "                    console.error('Failed to copy coordinates: ', err);\n";
-                            htmlFile << "                });\n";
-                            htmlFile << "            } else {\n";
-                            htmlFile << "                // Fallback for older browsers\n";
-                            htmlFile << "                var textArea = document.createElement('textarea');\n";
-                            htmlFile << "                textArea.value = coordString;\n";
-                            htmlFile << "                document.body.appendChild(textArea);\n";
-                            htmlFile << "                textArea.select();\n";
-                            htmlFile << "                document.execCommand('copy');\n";
-                            htmlFile << "                document.body.removeChild(textArea);\n";
-                            htmlFile << "            }\n";
-                            htmlFile << "            // Don't prevent the popup from showing\n";
-                            htmlFile << "        });\n\n";
-
-                            // Calculate width based on stand name length
-                            int labelWidth = std::max(30, static_cast<int>(standName.length()) * 8);
-
-                            // Add stand label
-                            htmlFile << "        var marker_" << standNameVar << " = L.marker([" << lat << ", " << lon << "], {\n";
-                            htmlFile << "            icon: L.divIcon({\n";
-                            htmlFile << "                className: 'stand-label',\n";
-                            htmlFile << "                html: '<div style=\"background-color: rgba(255,255,255,0.8); padding: 2px 4px; border-radius: 3px; font-weight: bold; font-size: 12px; color: black; text-align: center; display: flex; align-items: center; justify-content: center; width: 100%; height: 100%; box-sizing: border-box;\">" << standName << "</div>',\n";
-                            htmlFile << "                iconSize: [" << labelWidth << ", 20],\n";
-                            htmlFile << "                iconAnchor: [" << labelWidth / 2 << ", 10]\n";
-                            htmlFile << "            })\n";
-                            htmlFile << "        }).addTo(map);\n";
-                            htmlFile << "        currentStandElements.push(marker_" << standNameVar << ");\n\n";
-                        }
-                        catch (...)
-                        {
-                            std::cout << YELLOW << "Warning: Invalid coordinates for stand " << standName << " (coords: " << coords << ")" << RESET << std::endl;
+        // Copies text, falling back to a hidden textarea outside secure contexts
+        function copyText(text, onDone) {
+            if (navigator.clipboard && window.isSecureContext) {
+                navigator.clipboard.writeText(text).then(function() {
+                    onDone(true);
+                }).catch(function(err) {
+                    console.error('Failed to copy coordinates: ', err);
+                    onDone(fallbackCopy(text));
+                });
+            } else {
+                onDone(fallbackCopy(text));
+            }
+        }
+
+        function fallbackCopy(text) {
+            var textArea = document.createElement('textarea');
+            textArea.value = text;
+            // Avoid scrolling to bottom
+            textArea.style.top = '0';
+            textArea.style.left = '0';
+            textArea.style.position = 'fixed';
+            document.body.appendChild(textArea);
+            textArea.focus();
+            textArea.select();
+            var successful = false;
+            try {
+                successful = document.execCommand('copy');
+            } catch (err) {
+                console.error('Fallback: Oops, unable to copy', err);
+            }
+            document.body.removeChild(textArea);
+            return successful;
+        }
+
+        // Stand rows: [name, lat, lon, radius, code, use, schengen (-1 unset, 0, 1),
+        // flags (1 apron, 2 radius set), wingspan, priority, callsigns, countries,
+        // block, remarks (key, value, ...), apron polygon, color index per mode,
+        // label slot]
+        function decodeStand(row) {
+            var stand = { name: row[0], lat: row[1], lon: row[2], radius: row[3] };
+            if (row[4]) stand.Code = row[4];
+            if (row[5]) stand.Use = row[5];
+            if (row[6] >= 0) stand.Schengen = row[6] === 1;
+            if (row[7] & 1) stand.Apron = true;
+            if (row[13].length) stand.Remark = true;
+            if (row[8] !== null) stand.Wingspan = row[8];
+            if (row[10].length) stand.Callsigns = row[10].join(', ');
+            if (row[9] !== null) stand.Priority = row[9];
+            stand.coordinates = row[1] + ':' + row[2] + ':' + ((row[7] & 2) ? row[3] : '');
+            return stand;
+        }
+
+        function popupFor(row, stand) {
+            var html = '<div class="stand-info">Stand: ' + escapeHtml(stand.name) + '</div>';
+            if (stand.Code) html += '<br>Code: ' + stand.Code;
+            if (stand.Use) html += '<br>Use: ' + stand.Use;
+            if (stand.Schengen !== undefined) html += '<br>Schengen: ' + (stand.Schengen ? 'Yes' : 'No');
+            if (stand.Apron) html += '<br>Apron: Yes';
+            if (stand.Wingspan !== undefined) html += '<br>Wingspan: ' + stand.Wingspan + 'm';
+            for (var i = 0; i + 1 < row[13].length; i += 2) {
+                html += '<br>Remark (' + escapeHtml(row[13][i]) + '): ' + escapeHtml(row[13][i + 1]);
+            }
+            if (stand.Priority !== undefined) html += '<br>Priority: ' + stand.Priority;
+            html += '<br>Radius: ' + stand.radius + 'm';
+            html += '<br>Coordinates: ' + stand.coordinates;
+            if (row[10].length) html += '<br>Callsigns: ' + escapeHtml(row[10].join(', '));
+            if (row[11].length) html += '<br>Countries: ' + escapeHtml(row[11].join(', '));
+            if (row[12].length) html += '<br>Blocked: ' + escapeHtml(row[12].join(', '));
+            return html;
+        }
+
+        // Clicking a stand copies the clicked position, the popup still opens
+        function copyClickedPosition(e) {
+            var coordString = e.latlng.lat.toFixed(6) + ':' + e.latlng.lng.toFixed(6);
+            copyText(coordString, function(ok) {
+                if (ok) console.log('Coordinates copied: ' + coordString);
+            });
+        }
+
+        function standShape(row, stand) {
+            var color = getStandColor(stand);
+            var style = { color: color, fillColor: color, fillOpacity: 0.4 };
+            var shape = row[14].length ? L.polygon(row[14], style) : L.circle([stand.lat, stand.lon], Object.assign({ radius: stand.radius }, style));
+            shape.addTo(map);
+            shape.bindPopup(popupFor(row, stand));
+            shape.on('click', copyClickedPosition);
+            return shape;
+        }
+
+        // One SVG shape and one label marker per stand; Leaflet handles their clicks
+        var svgStands = {
+            add: function(item, row) {
+                item.circle = standShape(row, item.stand);
+
+                // Label width follows the name length
+                var labelWidth = Math.max(30, item.stand.name.length * 8);
+                item.marker = L.marker([item.stand.lat, item.stand.lon], {
+                    icon: L.divIcon({
+                        className: 'stand-label',
+                        html: '<div>' + escapeHtml(item.stand.name) + '</div>',
+                        iconSize: [labelWidth, 20],
+                        iconAnchor: [Math.floor(labelWidth / 2), 10]
+                    })
+                });
+                item.labelOn = labelShown(item);
+                if (item.labelOn) item.marker.addTo(map);
+            },
+
+            // Moves the existing layers; only a switch between circle and apron polygon
+            // replaces the shape
+            update: function(item, row) {
+                var stand = item.stand;
+                var isPolygon = row[14].length > 0;
+                if (isPolygon !== (item.circle instanceof L.Polygon)) {
+                    map.removeLayer(item.circle);
+                    item.circle = standShape(row, stand);
+                } else {
+                    if (isPolygon) {
+                        item.circle.setLatLngs(row[14]);
+                    } else {
+                        item.circle.setLatLng([stand.lat, stand.lon]);
+                        item.circle.setRadius(stand.radius);
+                    }
+                    item.circle.setPopupContent(popupFor(row, stand));
+                }
+                item.marker.setLatLng([stand.lat, stand.lon]);
+            },
+
+            remove: function(item) {
+                map.removeLayer(item.circle);
+                map.removeLayer(item.marker);
+            },
+
+            clear: function(items) {
+                items.forEach(this.remove);
+            },
+
+            setColor: function(item, color) {
+                if (item.circle && typeof item.circle.setStyle === 'function') {
+                    item.circle.setStyle({ color: color, fillColor: color, fillOpacity: 0.45 });
+                }
+                // The label background takes the stand color too
+                if (item.marker && item.marker._icon) {
+                    var inner = item.marker._icon.querySelector('div');
+                    if (inner) inner.style.backgroundColor = color;
+                }
+            },
+
+            colorsChanged: function() {},
+
+            // Only the labels of the zoom are in the page
+            labelsChanged: function() {
+                standItems.forEach(function(item) {
+                    var on = labelShown(item);
+                    if (on === item.labelOn) return;
+                    item.labelOn = on;
+                    if (on) item.marker.addTo(map);
+                    else map.removeLayer(item.marker);
+                });
+            },
+
+            standAt: function() { return null; }
+        };
+
+        // Stands and their labels drawn on a single canvas, redrawn when the view
+        // settles and scaled along during zoom animations. Positions are kept projected
+        // at zoom 0 and only scaled to the current zoom; a grid over the same space
+        // finds the stand under the pointer for popups.
+        var GRID_CELL = 1 / 1024;  // zoom-0 pixels, about 150 m at the equator
+        var GRID_ROW = 1 << 20;
+        var EARTH_CIRCUMFERENCE = 40075016.686;
+
+        var StandCanvas = L.Layer.extend({
+            options: { pane: 'overlayPane', padding: 0.3 },
+
+            initialize: function() {
+                this._items = [];
+                this._grid = new Map();
+                this._frame = null;
+            },
+
+            onAdd: function() {
+                this._canvas = L.DomUtil.create('canvas', 'leaflet-zoom-animated');
+                this._canvas.style.pointerEvents = 'none';
+                this.getPane().appendChild(this._canvas);
+                this._context = this._canvas.getContext('2d');
+                this._draw();
+            },
+
+            onRemove: function() {
+                L.DomUtil.remove(this._canvas);
+                this._map.getContainer().style.cursor = '';
+            },
+
+            getEvents: function() {
+                return { moveend: this._draw, resize: this._draw, viewreset: this._draw, zoomanim: this._animateZoom, mousemove: this._hover };
+            },
+
+            add: function(item, row) {
+                this._place(item, row);
+                this._items.push(item);
+                this._index(item);
+                this._schedule();
+            },
+
+            update: function(item, row) {
+                this._unindex(item);
+                this._place(item, row);
+                this._index(item);
+                this._schedule();
+            },
+
+            remove: function(item) {
+                this._unindex(item);
+                this._items.splice(this._items.indexOf(item), 1);
+                this._schedule();
+            },
+
+            clear: function() {
+                this._items = [];
+                this._grid = new Map();
+                this._schedule();
+            },
+
+            // The label background takes the stand color too
+            setColor: function(item, color) {
+                item.color = color;
+                item.labelColor = color;
+            },
+
+            colorsChanged: function() {
+                this._schedule();
+            },
+
+            labelsChanged: function() {
+                this._schedule();
+            },
+
+            // Topmost stand containing the position, if any
+            standAt: function(latlng) {
+                var point = this._map.project(latlng, 0);
+                var cell = this._grid.get(Math.floor(point.x / GRID_CELL) * GRID_ROW + Math.floor(point.y / GRID_CELL));
+                if (!cell) return null;
+                for (var i = cell.length - 1; i >= 0; i--) {
+                    if (this._contains(cell[i], point.x, point.y)) return cell[i];
+                }
+                return null;
+            },
+
+            _place: function(item, row) {
+                var map = this._map;
+                var center = map.project([item.stand.lat, item.stand.lon], 0);
+                item.x = center.x;
+                item.y = center.y;
+                item.labelWidth = Math.max(30, item.stand.name.length * 8);
+                if (!item.color) item.color = getStandColor(item.stand);
+                if (row[14].length) {
+                    item.polygon = row[14].map(function(latlng) {
+                        var point = map.project(latlng, 0);
+                        return [point.x, point.y];
+                    });
+                    item.box = [Infinity, Infinity, -Infinity, -Infinity];
+                    item.polygon.forEach(function(point) {
+                        item.box[0] = Math.min(item.box[0], point[0]);
+                        item.box[1] = Math.min(item.box[1], point[1]);
+                        item.box[2] = Math.max(item.box[2], point[0]);
+                        item.box[3] = Math.max(item.box[3], point[1]);
+                    });
+                } else {
+                    // Meters to zoom-0 pixels at the stand's latitude
+                    item.polygon = null;
+                    item.r = item.stand.radius * 256 / (EARTH_CIRCUMFERENCE * Math.cos(item.stand.lat * Math.PI / 180));
+                    item.box = [item.x - item.r, item.y - item.r, item.x + item.r, item.y + item.r];
+                }
+            },
+
+            _index: function(item) {
+                item.cells = [];
+                var x0 = Math.floor(item.box[0] / GRID_CELL), x1 = Math.floor(item.box[2] / GRID_CELL);
+                var y0 = Math.floor(item.box[1] / GRID_CELL), y1 = Math.floor(item.box[3] / GRID_CELL);
+                for (var x = x0; x <= x1; x++) {
+                    for (var y = y0; y <= y1; y++) {
+                        var key = x * GRID_ROW + y;
+                        var cell = this._grid.get(key);
+                        if (!cell) this._grid.set(key, cell = []);
+                        cell.push(item);
+                        item.cells.push(key);
+                    }
+                }
+            },
+
+            _unindex: function(item) {
+                var grid = this._grid;
+                (item.cells || []).forEach(function(key) {
+                    var cell = grid.get(key);
+                    if (!cell) return;
+                    cell.splice(cell.indexOf(item), 1);
+                    if (!cell.length) grid.delete(key);
+                });
+                item.cells = [];
+            },
+
+            _contains: function(item, x, y) {
+                if (!item.polygon) {
+                    var dx = x - item.x, dy = y - item.y;
+                    return dx * dx + dy * dy <= item.r * item.r;
+                }
+                if (x < item.box[0] || x > item.box[2] || y < item.box[1] || y > item.box[3]) return false;
+                var inside = false, points = item.polygon;
+                for (var i = 0, j = points.length - 1; i < points.length; j = i++) {
+                    if ((points[i][1] > y) !== (points[j][1] > y) &&
+                        x < (points[j][0] - points[i][0]) * (y - points[i][1]) / (points[j][1] - points[i][1]) + points[i][0]) {
+                        inside = !inside;
+                    }
+                }
+                return inside;
+            },
+
+            // Edits come in batches, the canvas is redrawn once per frame at most
+            _schedule: function() {
+                if (this._frame || !this._map) return;
+                this._frame = L.Util.requestAnimFrame(function() {
+                    this._frame = null;
+                    this._draw();
+                }, this);
+            },
+
+            _animateZoom: function(e) {
+                var scale = this._map.getZoomScale(e.zoom, this._zoom);
+                var offset = this._map._latLngToNewLayerPoint(this._topLeft, e.zoom, e.center);
+                L.DomUtil.setTransform(this._canvas, offset, scale);
+            },
+
+            _hover: function(e) {
+                this._map.getContainer().style.cursor = this.standAt(e.latlng) ? 'pointer' : '';
+            },
+
+            _draw: function() {
+                var map = this._map;
+                if (!map) return;
+                if (this._frame) {
+                    L.Util.cancelAnimFrame(this._frame);
+                    this._frame = null;
+                }
+                // Covers the view plus a margin, so short pans show no empty border
+                var size = map.getSize();
+                var pad = size.multiplyBy(this.options.padding).round();
+                var width = size.x + 2 * pad.x, height = size.y + 2 * pad.y;
+                var topLeft = map.containerPointToLayerPoint(pad.multiplyBy(-1)).round();
+                this._zoom = map.getZoom();
+                this._topLeft = map.layerPointToLatLng(topLeft);
+                L.DomUtil.setPosition(this._canvas, topLeft);
+
+                var ratio = window.devicePixelRatio || 1;
+                var canvas = this._canvas, context = this._context;
+                canvas.width = Math.round(width * ratio);
+                canvas.height = Math.round(height * ratio);
+                canvas.style.width = width + 'px';
+                canvas.style.height = height + 'px';
+                context.setTransform(ratio, 0, 0, ratio, 0, 0);
+                context.clearRect(0, 0, width, height);
+
+                // Zoom-0 pixels to canvas pixels
+                var scale = map.getZoomScale(this._zoom, 0);
+                var origin = topLeft.add(map.getPixelOrigin());
+                var visible = [];
+                context.lineWidth = 3;
+                context.lineJoin = 'round';
+                for (var i = 0; i < this._items.length; i++) {
+                    var item = this._items[i];
+                    var box = item.box;
+                    if (box[2] * scale - origin.x < -3 || box[0] * scale - origin.x > width + 3 ||
+                        box[3] * scale - origin.y < -3 || box[1] * scale - origin.y > height + 3) continue;
+                    context.beginPath();
+                    if (item.polygon) {
+                        for (var j = 0; j < item.polygon.length; j++) {
+                            context.lineTo(item.polygon[j][0] * scale - origin.x, item.polygon[j][1] * scale - origin.y);
                         }
+                        context.closePath();
+                    } else {
+                        context.arc(item.x * scale - origin.x, item.y * scale - origin.y, Math.max(item.r * scale, 1), 0, Math.PI * 2);
                     }
+                    context.globalAlpha = 0.4;
+                    context.fillStyle = item.color;
+                    context.fill();
+                    context.globalAlpha = 1;
+                    context.strokeStyle = item.color;
+                    context.stroke();
+                    visible.push(item);
+                }
+
+                // Labels after every shape so none is covered by a neighbour
+                context.font = 'bold 12px "Helvetica Neue", Arial, Helvetica, sans-serif';
+                context.textAlign = 'center';
+                context.textBaseline = 'middle';
+                for (var k = 0; k < visible.length; k++) {
+                    var label = visible[k];
+                    if (!labelShown(label)) continue;
+                    var x = Math.round(label.x * scale - origin.x), y = Math.round(label.y * scale - origin.y);
+                    context.fillStyle = label.labelColor || 'rgba(255,255,255,0.8)';
+                    context.fillRect(x - label.labelWidth / 2, y - 10, label.labelWidth, 20);
+                    context.fillStyle = 'black';
+                    context.fillText(label.stand.name, x, y);
                 }
             }
+        });
+
+        // Set on the first load: 'auto' draws on a canvas from CANVAS_STANDS stands on,
+        // where one SVG shape and one label element per stand make panning stutter
+        var CANVAS_STANDS = 1000;
+        var standLayer = null;
+
+        function pickStandLayer(count) {
+            if (STAND_RENDERER === 'svg' || (STAND_RENDERER === 'auto' && count < CANVAS_STANDS)) return svgStands;
+            return new StandCanvas().addTo(map);
         }
 
-        // Emit JS to adjust view to include all stands (fitBounds) or center on single stand
-        // Only apply auto-fit on first load (when no saved position exists)
-        htmlFile << "        // Only auto-fit if no saved position exists (first load)\n";
-        htmlFile << "        if (!savedCenter && !savedZoom) {\n";
-        if (validStands == 0)
-        {
-            // keep default center/zoom
+        function addStand(row) {
+            var item = { id: row[0], stand: decodeStand(row), row: row };
+            standLayer.add(item, row);
+            standsByName[item.id] = item;
+            standItems.push(item);
         }
-        else if (validStands == 1)
-        {
-            htmlFile << "            // Center on single stand\n";
-            htmlFile << "            map.setView([" << firstLat << ", " << firstLon << "], 16);\n";
+
+        function removeStand(name) {
+            var item = standsByName[name];
+            if (!item) return;
+            standLayer.remove(item);
+            delete standsByName[name];
+            standItems.splice(standItems.indexOf(item), 1);
         }
-        else
-        {
-            htmlFile << "            // Fit map to bounds covering all stands\n";
-            htmlFile << "            var bounds = L.latLngBounds([ [" << minLat << ", " << minLon << "], [" << maxLat << ", " << maxLon << "] ]);\n";
-            htmlFile << "            map.fitBounds(bounds, { padding: [80, 80] });\n";
+
+        function clearStands() {
+            if (standLayer) standLayer.clear(standItems);
+            standsByName = {};
+            standItems.length = 0;
         }
-        htmlFile << "        }\n";
 
-        htmlFile << R"(
-        
+        function updateStand(row) {
+            var item = standsByName[row[0]];
+            if (!item) return addStand(row);
+            item.stand = decodeStand(row);
+            item.row = row;
+            standLayer.update(item, row);
+        }
+
+        function fitStands(data) {
+            if (data.bounds) {
+                // Fit map to bounds covering all stands
+                map.fitBounds(L.latLngBounds(data.bounds), { padding: [80, 80] });
+            } else if (data.single) {
+                // Center on single stand
+                map.setView(data.single, 16);
+            }
+        }
+
+        function standsChanged() {
+            if (window.__mapColoring) window.__mapColoring.refresh();
+        }
+
+        // Stand data is written next to the page on every edit
+        function loadStands() {
+            return fetch(DATA_FILE, { cache: 'no-cache' })
+                .then(function(response) { return response.json(); })
+                .then(function(data) {
+                    clearStands();
+                    if (!standLayer) standLayer = pickStandLayer(data.stands.length);
+                    standPalettes = data.palettes;
+                    setLabels(data.labels);
+                    data.stands.forEach(addStand);
+                    standLayer.labelsChanged();
+                    standSession = data.session;
+                    standRevision = data.revision;
+                    return data;
+                });
+        }
+
+        // Applies the last render's delta when it starts from what is drawn, and
+        // falls back to the full data otherwise (missed render, new session)
+        function updateStands() {
+            return fetch(DELTA_FILE, { cache: 'no-cache' })
+                .then(function(response) { return response.json(); })
+                .then(function(delta) {
+                    // Already drawn, e.g. a second signal for the same render
+                    if (delta.session === standSession && delta.to === standRevision) return;
+                    if (delta.session !== standSession || delta.from !== standRevision) return loadStands();
+                    standPalettes = delta.palettes;
+                    setLabels(delta.labels);
+                    delta.removed.forEach(removeStand);
+                    delta.changed.forEach(updateStand);
+                    standLayer.labelsChanged();
+                    standRevision = delta.to;
+                })
+                .catch(function() { return loadStands(); })
+                .then(standsChanged)
+                .catch(function(error) {
+                    console.error('Failed to update stands: ', error);
+                });
+        }
+
+        var standsReady = loadStands()
+            .then(function(data) {
+                // Only auto-fit if no saved position exists (first load)
+                if (!savedCenter && !savedZoom) fitStands(data);
+            })
+            .catch(function(error) {
+                console.error('Failed to load ' + DATA_FILE + ': ', error);
+            });
+
         // Add click event to copy coordinates to clipboard
         map.on('click', function(e) {
+            // Canvas stands are not layers of their own, their popups open from here
+            var hit = standLayer && standLayer.standAt(e.latlng);
+            if (hit) {
+                copyClickedPosition(e);
+                L.popup().setLatLng(e.latlng).setContent(popupFor(hit.row, hit.stand)).openOn(map);
+                return;
+            }
             var lat = e.latlng.lat.toFixed(6);
             var lng = e.latlng.lng.toFixed(6);
             var coordString = lat + ':' + lng;
-            
-            // Copy to clipboard
-            if (navigator.clipboard && window.isSecureContext) {
-            navigator.clipboard.writeText(coordString).then(function() {
-            // Show temporary popup at click location
-            var popup = L.popup()
-            .setLatLng(e.latlng)
-            .setContent('<div style="text-align: center;"><strong>Coordinates copied!</strong><br>' + coordString + '</div>')
-            .openOn(map);
-            
-            // Auto-close popup after 2 seconds
-            setTimeout(function() {
-            map.closePopup(popup);
-            }, 2000);
-            }).catch(function(err) {
-            console.error('Failed to copy coordinates: ', err);
-            // Fallback method
-            fallbackCopyTextToClipboard(coordString, e.latlng);
+            copyText(coordString, function(ok) {
+                // Show temporary popup at click location
+                var popup = L.popup()
+                    .setLatLng(e.latlng)
+                    .setContent('<div style="text-align: center;"><strong>' +
+                        (ok ? 'Coordinates copied!' : 'Copy failed - please copy manually') +
+                        '</strong><br>' + coordString + '</div>')
+                    .openOn(map);
+                // Auto-close popup after 2 seconds
+                setTimeout(function() {
+                    map.closePopup(popup);
+                }, 2000);
             });
-            } else {
-            // Fallback for older browsers
-            fallbackCopyTextToClipboard(coordString, e.latlng);
-            }
         });
-        
-        // Fallback copy function for older browsers
-        function fallbackCopyTextToClipboard(text, latlng) {
-            var textArea = document.createElement("textarea");
-            textArea.value = text;
-            
-            // Avoid scrolling to bottom
-            textArea.style.top = "0";
-            textArea.style.left = "0";
-            textArea.style.position = "fixed";
-            
-            document.body.appendChild(textArea);
-            textArea.focus();
-            textArea.select();
-            
-            try {
-            var successful = document.execCommand('copy');
-            var popup = L.popup()
-            .setLatLng(latlng)
-            .setContent('<div style="text-align: center;"><strong>' + 
-                   (successful ? 'Coordinates copied!' : 'Copy failed - please copy manually') + 
-                   '</strong><br>' + text + '</div>')
-            .openOn(map);
-            
-            setTimeout(function() {
-            map.closePopup(popup);
-            }, 2000);
-            } catch (err) {
-            console.error('Fallback: Oops, unable to copy', err);
-            }
-            
-            document.body.removeChild(textArea);
-        }
 
         /* Color-mode control UI */
         (function() {
@@ -501,106 +725,9 @@ void generateMap(const nlohmann::ordered_json &configJson, const std::string &ic
             }
             });
 
-            // Utility: HSL gradient for priority (-100..100) => blue (240) -> green (120) -> red (0)
-            function colorForPriority(p) {
-            if (p === undefined || p === null || isNaN(p)) return '#96CEB4';
-            var v = Number(p);
-            // Clamp to -100..100
-            v = Math.max(-100, Math.min(100, v));
-            // Normalize to 0..1 where -100 => 0, 0 => 0.5, 100 => 1
-            var t = (v + 100) / 200;
-            // Map to hue: 240 (blue) -> 120 (green) -> 0 (red)
-            var hue = 240 * (1 - t);
-            return 'hsl(' + Math.round(hue) + ',70%,50%)';
-            }
-
-            // Build a set of stands by inspecting global vars like stand_<name>
+            // Every drawn stand with its shape and label, built once at load
             function collectStands() {
-            var list = [];
-            for (var k in window) {
-            if (!Object.prototype.hasOwnProperty.call(window, k)) continue;
-            if (k.indexOf('stand_') === 0) {
-            try {
-                var stand = window[k];
-                var shortName = k.substring(6); // suffix used for circle_ and marker_
-                var circle = window['circle_' + shortName];
-                var marker = window['marker_' + shortName];
-                // Only include if a circle exists
-                if (circle) {
-                list.push({ id: shortName, stand: stand, circle: circle, marker: marker });
-                }
-            } catch (e) {
-                // ignore
-            }
-            }
-            }
-            return list;
-            }
-
-            // Determine color by selected mode
-            function determineColor(mode, stand) {
-            if (mode === 'default') {
-            return '#96CEB4';
-            }
-            if (mode === 'schengen') {
-            if (stand.Schengen === false) return '#4e70cdff';
-            if (stand.Schengen === true) return '#45B7D1';
-            return '#96CEB4';
-            }
-            if (mode === 'apron') {
-            return stand.Apron ? '#FF6B6B' : '#96CEB4';
-            }
-            if (mode === 'use') {
-            // categorical mapping for common uses. New categories get assigned deterministic colors.
-            var map = {
-            'Commercial': '#4E79A7',
-            'Cargo': '#59A14F',
-            'Military': '#E15759',
-            'General': '#F28E2B',
-            'Maintenance': '#B07AA1',
-            'Default': '#96CEB4'
-            };
-            var u = stand.Use || stand.use || 'Default';
-            if (map[u]) return map[u];
-            // deterministic color by hashing the use string
-            var hash = 0;
-            for (var i = 0; i < u.length; i++) hash = (hash << 5) - hash + u.charCodeAt(i);
-            var hue = Math.abs(hash) % 360;
-            return 'hsl(' + hue + ',65%,55%)';
-            }
-            if (mode === 'priority') {
-            var p = stand.Priority;
-            return colorForPriority(p);
-            }
-            if (mode === 'codeHighest') {
-            if (!stand.Code) return '#96CEB4';
-            var code = stand.Code.toString().toUpperCase();
-            var highestChar = 0;
-            for (var i = 0; i < code.length; i++) {
-                var c = code.charCodeAt(i);
-                if (c > highestChar) highestChar = c;
-            }
-            var hue = (highestChar * 37) % 360; // arbitrary multiplier for distribution
-            return 'hsl(' + hue + ',65%,55%)';
-            }
-            if (mode === 'codeAll') {
-            if (!stand.Code) return '#96CEB4';
-            var code = stand.Code.toString().toUpperCase();
-            var hash = 0;
-            for (var i = 0; i < code.length; i++) hash = (hash << 5) - hash + code.charCodeAt(i);
-            var hue = Math.abs(hash) % 360;
-            return 'hsl(' + hue + ',65%,55%)';
-            }
-            if (mode === 'remark') {
-            return stand.Remark ? '#FFB347' : '#96CEB4';
-            }
-            if (mode === 'wingspan') {
-            return stand.Wingspan ? '#FFB347' : '#96CEB4';
-            }
-            if (mode === 'callsign') {
-            return (stand.Callsigns && stand.Callsigns.length > 0) ? '#FFB347' : '#96CEB4';
-            }
-            return '#96CEB4';
+            return standItems;
             }
 
             // Create legend control (top-right)
@@ -619,148 +746,55 @@ void generateMap(const nlohmann::ordered_json &configJson, const std::string &ic
             return '<div style="display:flex;align-items:center;margin:4px 0;"><span style="width:18px;height:14px;background:' + color + ';border:1px solid rgba(0,0,0,0.15);margin-right:8px;display:inline-block;border-radius:2px;"></span><span style="flex:1;word-break:break-word;">' + label + '</span></div>';
             }
 
-            // Update legend based on current mode and available stands
-            function updateLegend(mode, items) {
+            // The legend comes with the stand data: every color of the mode with the
+            // number of stands that have it, and the priority range
+            function updateLegend(mode, palette) {
             var content = document.getElementById('legendContent');
             if (!content) return;
-            content.innerHTML = ''; // clear
 
-            if (!items || items.length === 0) {
+            if (!palette || standItems.length === 0) {
             content.innerHTML = '<div style="color:#666">No stands found</div>';
             return;
             }
 
-            // Helper: collect unique keys/values
-            function unique(arr) {
-            return Array.from(new Set(arr));
-            }
-
-            if (mode === 'default') {
-            content.innerHTML = swatchHTML(determineColor('default', {}), 'Stands');
-            return;
-            }
-
-            if (mode === 'schengen') {
-            content.innerHTML += swatchHTML('#45B7D1', 'Schengen');
-            content.innerHTML += swatchHTML('#4e70cdff', 'Non-Schengen');
-            content.innerHTML += swatchHTML('#96CEB4', 'Either');
-            return;
-            }
-
-            if (mode === 'apron') {
-            content.innerHTML += swatchHTML('#FF6B6B', 'Apron');
-            content.innerHTML += swatchHTML('#96CEB4', 'Stand');
-            return;
-            }
-
-            if (mode === 'remark' || mode === 'wingspan' || mode === 'callsign') {
-            var yesColor = '#FFB347';
-            var noColor = '#96CEB4';
-            var yesLabel = (mode === 'remark') ? 'Has Remark' : (mode === 'wingspan' ? 'Has Wingspan' : 'Has Callsign(s)');
-            content.innerHTML += swatchHTML(yesColor, yesLabel);
-            content.innerHTML += swatchHTML(noColor, 'None');
-            return;
-            }
-
-            if (mode === 'priority') {
-            // find min/max priority values present
-            var vals = items.map(function(it) { return (it.stand && it.stand.Priority != null) ? Number(it.stand.Priority) : NaN; }).filter(function(v){ return !isNaN(v); });
-            var min = vals.length ? Math.min.apply(null, vals) : -100;
-            var max = vals.length ? Math.max.apply(null, vals) : 100;
-            var grad = 'linear-gradient(90deg, ' + colorForPriority(min) + ' 0%,' + colorForPriority((min+max)/2) + ' 50%,' + colorForPriority(max) + ' 100%)';
-            content.innerHTML += '<div style="display:flex;flex-direction:column;"><div style="height:14px;border-radius:4px;border:1px solid rgba(0,0,0,0.06);background:' + grad + ';margin-bottom:6px;"></div><div style="font-size:11px;color:#333;">Priority range: ' + min + ' — ' + max + ' (-100..100)</div></div>';
-            return;
-            }
-
-            if (mode === 'use') {
-            // collect distinct uses
-            var uses = items.map(function(it){ return (it.stand && (it.stand.Use || it.stand.use)) ? (it.stand.Use || it.stand.use) : 'N/A'; });
-            uses = unique(uses);
-            uses.forEach(function(u){
-            var color = determineColor('use', { Use: u });
-            content.innerHTML += swatchHTML(color, u);
-            });
-            return;
-            }
-            
-            if (mode === 'codeHighest') {
-            // collect distinct highest chars
-            var codes = items.map(function(it){
-            if (it.stand && it.stand.Code) {
-                var code = it.stand.Code.toString().toUpperCase();
-                var highestChar = 0;
-                for (var i = 0; i < code.length; i++) {
-                var c = code.charCodeAt(i);
-                if (c > highestChar) highestChar = c;
-                }
-                return String.fromCharCode(highestChar);
-            }
-            return null;
-            }).filter(function(c){ return c !== null; });
-            codes = unique(codes);
-            codes.forEach(function(code){
-            var color = determineColor('codeHighest', { Code: code });
-            content.innerHTML += swatchHTML(color, 'Highest char: ' + code);
-            });
-            return;
-            }
-
-            if (mode === 'codeAll') {
-            // collect distinct codes
-            var codes = items.map(function(it){ return (it.stand && it.stand.Code) ? it.stand.Code.toString() : null; }).filter(function(c){ return c !== null; });
-            codes = unique(codes);
-            if (codes.length === 0) {
-            content.innerHTML = '<div style="color:#666">No Code values found</div>';
-            return;
+            var html = '';
+            if (palette.range) {
+            var grad = 'linear-gradient(90deg, ' + palette.gradient[0] + ' 0%,' + palette.gradient[1] + ' 50%,' + palette.gradient[2] + ' 100%)';
+            html += '<div style="display:flex;flex-direction:column;"><div style="height:14px;border-radius:4px;border:1px solid rgba(0,0,0,0.06);background:' + grad + ';margin-bottom:6px;"></div><div style="font-size:11px;color:#333;">Priority range: ' + palette.range[0] + ' — ' + palette.range[1] + ' (-100..100)</div></div>';
             }
             // limit to reasonable number to avoid huge legend
-            var maxEntries = 100;
-            codes.slice(0, maxEntries).forEach(function(code){
-            var color = determineColor(mode, { Code: code });
-            content.innerHTML += swatchHTML(color, 'Code: ' + code);
-            });
-            if (codes.length > maxEntries) {
-            content.innerHTML += '<div style="color:#666;font-size:11px;margin-top:6px;">... ' + (codes.length - maxEntries) + ' more entries omitted</div>';
+            var maxEntries = 100, shown = 0, omitted = 0;
+            for (var i = 0; i < palette.colors.length; i++) {
+            if (!palette.counts[i]) continue;
+            if (palette.range && palette.labels[i] !== 'None') continue;
+            if (shown === maxEntries) { omitted++; continue; }
+            html += swatchHTML(palette.colors[i], escapeHtml(palette.labels[i]) + ' (' + palette.counts[i] + ')');
+            shown++;
             }
-            return;
+            if (omitted) {
+            html += '<div style="color:#666;font-size:11px;margin-top:6px;">... ' + omitted + ' more entries omitted</div>';
             }
-
-            // fallback: try to show a few items with computed colors
-            items.slice(0, 25).forEach(function(it){
-            var label = (it.stand && it.stand.name) ? it.stand.name : it.id;
-            var color = determineColor(mode, it.stand || {});
-            content.innerHTML += swatchHTML(color, label);
-            });
+            content.innerHTML = html;
             }
 
-            // Apply coloring to map elements
+            // Apply coloring to map elements: each stand carries its color index for
+            // every mode, so this is one lookup per stand
             function applyColoring(mode) {
-            var items = collectStands();
-            items.forEach(function(it) {
-            try {
-            var c = determineColor(mode, it.stand);
-            // Set style on circle
-            if (it.circle && typeof it.circle.setStyle === 'function') {
-                it.circle.setStyle({ color: c, fillColor: c, fillOpacity: 0.45 });
-            }
-            // Optionally adjust marker background (small square around label)
-            if (it.marker && it.marker._icon) {
-                // try to find the inner div and adjust its background-color
-                var inner = it.marker._icon.querySelector('div');
-                if (inner) inner.style.backgroundColor = c;
-            }
-            } catch (e) {
-            console.error('Failed coloring stand', it.id, e);
-            }
+            var m = COLOR_MODES.indexOf(mode);
+            var palette = standPalettes && standPalettes[m];
+            if (palette) {
+            standItems.forEach(function(it) {
+            standLayer.setColor(it, palette.colors[it.row[15][m]]);
             });
+            standLayer.colorsChanged();
+            }
 
             // Update info text
             var info = document.getElementById('colorModeInfo');
             if (info) info.innerText = 'Current: ' + (mode.charAt(0).toUpperCase() + mode.slice(1));
 
-            // Update legend to reflect the chosen mode and discovered properties
             try {
-            updateLegend(mode, items);
+            updateLegend(mode, palette);
             } catch (e) {
             console.error('Failed to update legend', e);
             }
@@ -771,6 +805,7 @@ void generateMap(const nlohmann::ordered_json &configJson, const std::string &ic
             radios.forEach(function(r) {
             r.addEventListener('change', function(e) {
             var mode = e.target.value;
+            savedMode = mode;
             applyColoring(mode);
             // Save the selected mode to localStorage for persistence
             localStorage.setItem('standFilter', mode);
@@ -790,14 +825,15 @@ void generateMap(const nlohmann::ordered_json &configJson, const std::string &ic
             savedMode = 'default';
             }
             
-            // Initial apply with saved or default mode
-            setTimeout(function() { applyColoring(savedMode); }, 50);
+            // Initial apply with saved or default mode once the stands are drawn
+            standsReady.then(function() { applyColoring(savedMode); });
 
             // Expose quick API for console debugging
             window.__mapColoring = {
             apply: applyColoring,
-            collect: collectStands,
-            colorForPriority: colorForPriority
+            // Recolors with the current mode after stands changed
+            refresh: function() { applyColoring(savedMode); },
+            collect: collectStands
             };
         })();
 
@@ -809,34 +845,17 @@ void generateMap(const nlohmann::ordered_json &configJson, const std::string &ic
         if (window.location.protocol === 'http:' && window.location.hostname === 'localhost') {
             console.log('🔄 Live reload enabled - monitoring for changes');
             
-            var lastReloadCheck = 0;
-            var reloadCheckInterval;
-            
-            function checkForReload() {
-            fetch('/reload_signal.txt?t=' + Date.now())
-            .then(response => response.text())
-            .then(timestamp => {
-            var currentCheck = parseInt(timestamp);
-            if (currentCheck > lastReloadCheck && lastReloadCheck > 0) {
-                console.log('✅ File updated! Saving map state and reloading page...');
-                // Save map state before reloading
-                saveMapState();
-                // Set flag so beforeunload doesn't clear storage
-                isAutoReloading = true;
-                window.location.reload(true);
-            }
-            lastReloadCheck = currentCheck;
-            })
-            .catch(error => {
-            console.log('Reload check failed:', error.message);
-            });
-            }
-            
-            // Check every 2 seconds
-            reloadCheckInterval = setInterval(checkForReload, 2000);
-            
-            // Initialize check
-            setTimeout(checkForReload, 1000);
+            // The server pushes a message whenever the stand files change, and one on every
+            // (re)connect so changes missed meanwhile are picked up. updateStands skips a
+            // render that is already drawn; waiting for the first load keeps it from racing.
+            var events = new EventSource('/events');
+            events.onmessage = function() {
+                console.log('🔄 Stand files signalled, applying changes...');
+                standsReady.then(updateStands);
+            };
+            events.onerror = function() {
+                console.log('Live reload connection lost, retrying...');
+            };
             
             // Add visual indicator
             var indicator = document.createElement('div');
@@ -860,22 +879,767 @@ void generateMap(const nlohmann::ordered_json &configJson, const std::string &ic
             }, 3000);
         }
           
-        </script>
+        )";
+
+    constexpr const char *pageFoot = R"(        </script>
         </body>
-        <!-- Generated: )"
-                 << timestamp << R"( -->
+        <!-- Generated: )";
+
+    constexpr const char *pageEnd = R"( -->
         </html>)";
 
-        htmlFile.close();
+    // JSON string literal that is also safe inside <script>: '<' is escaped so no
+    // stand name can close the tag
+    void appendString(std::string &out, const std::string &text)
+    {
+        out += '"';
+        for (unsigned char c : text)
+        {
+            if (c == '"' || c == '\\')
+            {
+                out += '\\';
+                out += static_cast<char>(c);
+            }
+            else if (c < 0x20 || c == '<')
+            {
+                char escaped[8];
+                std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                out += escaped;
+            }
+            else
+            {
+                out += static_cast<char>(c);
+            }
+        }
+        out += '"';
+    }
+
+    void appendList(std::string &out, const StandTable &stands, uint32_t listId)
+    {
+        out += '[';
+        const std::vector<uint32_t> &ids = stands.list(listId);
+        for (size_t i = 0; i < ids.size(); i++)
+        {
+            if (i)
+                out += ',';
+            appendString(out, stands.string(ids[i]));
+        }
+        out += ']';
+    }
 
-        std::cout << GREEN << "HTML map generated: " << filename << RESET << std::endl;
+    void appendOptional(std::string &out, std::optional<int> value)
+    {
+        if (value)
+            appendInteger(out, *value);
+        else
+            out += "null";
+    }
 
-        if (!g_liveServer)
+    // Modes of the page's color panel, in the order of a row's color indices
+    // (COLOR_MODES in the page script)
+    enum ColorMode
+    {
+        DefaultColors,
+        SchengenColors,
+        ApronColors,
+        UseColors,
+        PriorityColors,
+        CodeHighestColors,
+        CodeAllColors,
+        RemarkColors,
+        WingspanColors,
+        CallsignColors,
+        colorModeCount
+    };
+
+    constexpr const char *defaultColor = "#96CEB4";
+    constexpr const char *flagColor = "#FFB347";
+
+    // Colors of one mode. Entries are only ever appended within a session, so the
+    // indices a page got with earlier renders stay valid when a delta adds one.
+    struct Palette
+    {
+        std::vector<std::string> colors;
+        std::vector<std::string> labels;
+        std::unordered_map<std::string, uint32_t> byKey;
+
+        uint32_t index(const std::string &key, const std::string &color, const std::string &label)
         {
-            g_liveServer = std::make_unique<LiveReloadServer>();
-            g_liveServer->startServer(filename);
-            std::this_thread::sleep_for(std::chrono::milliseconds(2000));
+            auto it = byKey.find(key);
+            if (it != byKey.end())
+                return it->second;
+            colors.push_back(color);
+            labels.push_back(label);
+            return byKey[key] = static_cast<uint32_t>(colors.size() - 1);
         }
+    };
+
+    using Palettes = std::array<Palette, colorModeCount>;
+    using ColorIndices = std::array<uint32_t, colorModeCount>;
+
+    // Two-state modes list their colors up front so the legend keeps its order
+    Palettes initialPalettes()
+    {
+        Palettes palettes;
+        palettes[DefaultColors].index("", defaultColor, "Stands");
+        palettes[SchengenColors].index("1", "#45B7D1", "Schengen");
+        palettes[SchengenColors].index("0", "#4e70cdff", "Non-Schengen");
+        palettes[SchengenColors].index("-1", defaultColor, "Either");
+        palettes[ApronColors].index("1", "#FF6B6B", "Apron");
+        palettes[ApronColors].index("0", defaultColor, "Stand");
+        palettes[RemarkColors].index("1", flagColor, "Has Remark");
+        palettes[RemarkColors].index("0", defaultColor, "None");
+        palettes[WingspanColors].index("1", flagColor, "Has Wingspan");
+        palettes[WingspanColors].index("0", defaultColor, "None");
+        palettes[CallsignColors].index("1", flagColor, "Has Callsign(s)");
+        palettes[CallsignColors].index("0", defaultColor, "None");
+        return palettes;
+    }
+
+    std::string hslColor(long hue, int saturation, int lightness)
+    {
+        return "hsl(" + std::to_string(hue) + "," + std::to_string(saturation) + "%," + std::to_string(lightness) + "%)";
+    }
+
+    // Same hue as the page always gave text values: the JavaScript string hash
+    // (hash << 5) - hash + c, with its 32-bit shift on a double
+    std::string hashedColor(const std::string &text)
+    {
+        double hash = 0;
+        for (unsigned char c : text)
+        {
+            auto bits = static_cast<uint32_t>(static_cast<int64_t>(hash));
+            hash = static_cast<double>(static_cast<int32_t>(bits << 5)) - hash + c;
+        }
+        return hslColor(static_cast<long>(std::fmod(std::fabs(hash), 360)), 65, 55);
+    }
+
+    // -100..100 maps blue (240) -> green (120) -> red (0)
+    std::string priorityColor(double priority)
+    {
+        double t = (std::max(-100.0, std::min(100.0, priority)) + 100) / 200;
+        return hslColor(static_cast<long>(std::floor(240 * (1 - t) + 0.5)), 70, 50);
+    }
+
+    ColorIndices standColors(const StandTable &stands, uint32_t row, bool isApron, Palettes &palettes)
+    {
+        ColorIndices indices;
+        indices[DefaultColors] = 0;
+        indices[SchengenColors] = palettes[SchengenColors].index(std::to_string(static_cast<int>(stands.schengen(row))), "", "");
+        indices[ApronColors] = palettes[ApronColors].index(isApron ? "1" : "0", "", "");
+        indices[RemarkColors] = palettes[RemarkColors].index(stands.list(stands.remarks(row)).empty() ? "0" : "1", "", "");
+        std::optional<int> wingspan = stands.wingspan(row);
+        indices[WingspanColors] = palettes[WingspanColors].index(wingspan && *wingspan ? "1" : "0", "", "");
+        indices[CallsignColors] = palettes[CallsignColors].index(stands.list(stands.callsigns(row)).empty() ? "0" : "1", "", "");
+
+        std::string use = useString(stands.use(row));
+        indices[UseColors] = use.empty() ? palettes[UseColors].index("", defaultColor, "N/A") : palettes[UseColors].index(use, hashedColor(use), use);
+
+        std::optional<int> priority = stands.priority(row);
+        indices[PriorityColors] = priority ? palettes[PriorityColors].index(std::to_string(*priority), priorityColor(*priority), "Priority " + std::to_string(*priority))
+                                           : palettes[PriorityColors].index("", defaultColor, "None");
+
+        std::string code = codeString(stands.code(row));
+        if (code.empty())
+        {
+            indices[CodeHighestColors] = palettes[CodeHighestColors].index("", defaultColor, "None");
+            indices[CodeAllColors] = palettes[CodeAllColors].index("", defaultColor, "None");
+        }
+        else
+        {
+            char highest = *std::max_element(code.begin(), code.end());
+            indices[CodeHighestColors] = palettes[CodeHighestColors].index(std::string(1, highest), hslColor((static_cast<unsigned char>(highest) * 37) % 360, 65, 55), std::string("Highest char: ") + highest);
+            indices[CodeAllColors] = palettes[CodeAllColors].index(code, hashedColor(code), "Code: " + code);
+        }
+        return indices;
+    }
+
+    // "palettes": per mode the colors, their labels and how many stands have each;
+    // priority also gets its range and the gradient over it
+    void appendPalettes(std::string &out, const Palettes &palettes, const std::array<std::vector<uint32_t>, colorModeCount> &counts, std::optional<std::pair<int, int>> priorityRange)
+    {
+        out += "\"palettes\":[";
+        for (size_t mode = 0; mode < colorModeCount; mode++)
+        {
+            const Palette &palette = palettes[mode];
+            out += mode ? ",\n{\"colors\":[" : "\n{\"colors\":[";
+            for (size_t i = 0; i < palette.colors.size(); i++)
+            {
+                if (i)
+                    out += ',';
+                appendString(out, palette.colors[i]);
+            }
+            out += "],\"labels\":[";
+            for (size_t i = 0; i < palette.labels.size(); i++)
+            {
+                if (i)
+                    out += ',';
+                appendString(out, palette.labels[i]);
+            }
+            out += "],\"counts\":[";
+            for (size_t i = 0; i < palette.colors.size(); i++)
+            {
+                if (i)
+                    out += ',';
+                appendInteger(out, i < counts[mode].size() ? counts[mode][i] : 0);
+            }
+            out += ']';
+            if (mode == PriorityColors && priorityRange)
+            {
+                auto [low, high] = *priorityRange;
+                out += ",\"range\":[" + std::to_string(low) + ',' + std::to_string(high) + "],\"gradient\":[";
+                appendString(out, priorityColor(low));
+                out += ',';
+                appendString(out, priorityColor((low + high) / 2.0));
+                out += ',';
+                appendString(out, priorityColor(high));
+                out += ']';
+            }
+            out += '}';
+        }
+        out += "\n]";
+    }
+
+    // One STANDS row, see decodeStand in the page script for the layout
+    ColorIndices appendStand(std::string &out, const StandTable &stands, uint32_t row, Palettes &palettes, uint32_t labelSlot)
+    {
+        const Apron *apron = stands.apron(row);
+        const nlohmann::ordered_json *extra = stands.extra(row);
+        bool isApron = apron || (extra && extra->contains("Apron") && (*extra)["Apron"] != false);
+        Coordinates coordinates = stands.coordinates(row);
+
+        out += '[';
+        appendString(out, stands.name(row));
+        out += ',';
+        appendNumber(out, coordinates.lat);
+        out += ',';
+        appendNumber(out, coordinates.lon);
+        out += ',';
+        appendNumber(out, stands.standRadius(row));
+        out += ',';
+        appendString(out, codeString(stands.code(row)));
+        out += ',';
+        appendString(out, useString(stands.use(row)));
+        out += ',';
+        appendInteger(out, static_cast<int>(stands.schengen(row)));
+        out += ',';
+        appendInteger(out, (isApron ? 1 : 0) | (coordinates.hasRadius ? 2 : 0));
+        out += ',';
+        appendOptional(out, stands.wingspan(row));
+        out += ',';
+        appendOptional(out, stands.priority(row));
+        out += ',';
+        appendList(out, stands, stands.callsigns(row));
+        out += ',';
+        appendList(out, stands, stands.countries(row));
+        out += ',';
+        appendList(out, stands, stands.block(row));
+        out += ',';
+        appendList(out, stands, stands.remarks(row));
+        out += ",[";
+        if (apron)
+        {
+            bool first = true;
+            for (const auto &coord : apron->coordinates)
+            {
+                Coordinates point;
+                if (!parseCoordinates(coord, point, false))
+                    continue;
+                out += first ? "[" : ",[";
+                appendNumber(out, point.lat);
+                out += ',';
+                appendNumber(out, point.lon);
+                out += ']';
+                first = false;
+            }
+        }
+        out += "],[";
+        ColorIndices colors = standColors(stands, row, isApron, palettes);
+        for (size_t mode = 0; mode < colorModeCount; mode++)
+        {
+            if (mode)
+                out += ',';
+            appendInteger(out, colors[mode]);
+        }
+        out += "],";
+        appendInteger(out, labelSlot);
+        out += ']';
+        return colors;
+    }
+
+    // Labels are drawn centered on their stand, 20 px high and 8 px per character
+    // (at least 30) wide at every zoom
+    constexpr double pi = 3.14159265358979323846;
+    constexpr double labelHeight = 20;
+    constexpr double labelCell = 64;
+    // Zoomed further out an airport is a few pixels wide, the sets of this zoom are used
+    constexpr int labelMinZoom = 10;
+    constexpr int labelMaxZoom = 19;
+
+    struct LabelBox
+    {
+        uint32_t slot;
+        // Web Mercator pixels at zoom 0
+        double x;
+        double y;
+        double width;
+    };
+
+    double labelWidth(const std::string &name)
+    {
+        // Characters, not UTF-8 bytes
+        size_t length = 0;
+        for (unsigned char c : name)
+            length += (c & 0xC0) != 0x80;
+        return std::max(30.0, static_cast<double>(length) * 8);
+    }
+
+    LabelBox labelBox(uint32_t slot, const std::string &name, double lat, double lon)
+    {
+        double sinLat = std::sin(lat * pi / 180);
+        double x = 256 * (lon + 180) / 360;
+        double y = 256 * (0.5 - std::log((1 + sinLat) / (1 - sinLat)) / (4 * pi));
+        return {slot, x, y, labelWidth(name)};
+    }
+
+    // Which labels to draw at each zoom from labelMinZoom on, one bit per label slot.
+    // A greedy pass over a grid of placed labels keeps a label unless it overlaps one
+    // kept before it. Labels kept at a zoom go first at the next one, where they are
+    // further apart and cannot collide, so zooming in never hides a label. Sets stop
+    // at the first zoom where every label fits, deeper zooms show them all.
+    std::vector<std::vector<uint8_t>> labelSets(const std::vector<LabelBox> &labels, uint32_t slots)
+    {
+        std::vector<std::vector<uint8_t>> sets;
+        std::vector<size_t> order(labels.size());
+        for (size_t i = 0; i < order.size(); i++)
+            order[i] = i;
+        std::unordered_map<uint64_t, std::vector<size_t>> grid;
+        std::vector<double> x(labels.size()), y(labels.size());
+        for (int zoom = labelMinZoom; zoom <= labelMaxZoom; zoom++)
+        {
+            double scale = std::ldexp(1.0, zoom);
+            for (size_t i = 0; i < labels.size(); i++)
+            {
+                x[i] = labels[i].x * scale;
+                y[i] = labels[i].y * scale;
+            }
+            grid.clear();
+            std::vector<size_t> kept, dropped;
+            for (size_t i : order)
+            {
+                auto cellX0 = static_cast<int64_t>(std::floor((x[i] - labels[i].width / 2) / labelCell));
+                auto cellX1 = static_cast<int64_t>(std::floor((x[i] + labels[i].width / 2) / labelCell));
+                auto cellY0 = static_cast<int64_t>(std::floor((y[i] - labelHeight / 2) / labelCell));
+                auto cellY1 = static_cast<int64_t>(std::floor((y[i] + labelHeight / 2) / labelCell));
+                bool overlaps = false;
+                for (int64_t cx = cellX0; cx <= cellX1 && !overlaps; cx++)
+                {
+                    for (int64_t cy = cellY0; cy <= cellY1 && !overlaps; cy++)
+                    {
+                        auto cell = grid.find(static_cast<uint64_t>(cx) << 32 | static_cast<uint32_t>(cy));
+                        if (cell == grid.end())
+                            continue;
+                        for (size_t other : cell->second)
+                        {
+                            if (std::fabs(x[i] - x[other]) < (labels[i].width + labels[other].width) / 2 && std::fabs(y[i] - y[other]) < labelHeight)
+                            {
+                                overlaps = true;
+                                break;
+                            }
+                        }
+                    }
+                }
+                if (overlaps)
+                {
+                    dropped.push_back(i);
+                    continue;
+                }
+                kept.push_back(i);
+                for (int64_t cx = cellX0; cx <= cellX1; cx++)
+                {
+                    for (int64_t cy = cellY0; cy <= cellY1; cy++)
+                        grid[static_cast<uint64_t>(cx) << 32 | static_cast<uint32_t>(cy)].push_back(i);
+                }
+            }
+            if (dropped.empty())
+                break;
+
+            std::vector<uint8_t> set((slots + 7) / 8, 0);
+            for (size_t i : kept)
+                set[labels[i].slot / 8] |= static_cast<uint8_t>(1 << (labels[i].slot % 8));
+            sets.push_back(std::move(set));
+            // Stand order within both groups
+            std::sort(kept.begin(), kept.end());
+            order = std::move(kept);
+            order.insert(order.end(), dropped.begin(), dropped.end());
+        }
+        return sets;
+    }
+
+    void appendBase64(std::string &out, const std::vector<uint8_t> &bytes)
+    {
+        static const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        out += '"';
+        for (size_t i = 0; i < bytes.size(); i += 3)
+        {
+            uint32_t chunk = static_cast<uint32_t>(bytes[i]) << 16;
+            if (i + 1 < bytes.size())
+                chunk |= static_cast<uint32_t>(bytes[i + 1]) << 8;
+            if (i + 2 < bytes.size())
+                chunk |= bytes[i + 2];
+            out += alphabet[chunk >> 18 & 63];
+            out += alphabet[chunk >> 12 & 63];
+            out += i + 1 < bytes.size() ? alphabet[chunk >> 6 & 63] : '=';
+            out += i + 2 < bytes.size() ? alphabet[chunk & 63] : '=';
+        }
+        out += '"';
+    }
+
+    // "labels": {from, full, sets}: sets[i] holds the labels to draw at zoom from + i,
+    // bit n of it (LSB first, base64) being the stand with label slot n (row[16]);
+    // every label is drawn from zoom full on
+    void appendLabels(std::string &out, const std::vector<LabelBox> &labels, uint32_t slots)
+    {
+        std::vector<std::vector<uint8_t>> sets = labelSets(labels, slots);
+        out += "\"labels\":{\"from\":" + std::to_string(labelMinZoom) + ",\"full\":" + std::to_string(labelMinZoom + sets.size()) + ",\"sets\":[";
+        for (size_t i = 0; i < sets.size(); i++)
+        {
+            if (i)
+                out += ',';
+            appendBase64(out, sets[i]);
+        }
+        out += "]}";
+    }
+
+    bool writeFile(const std::string &path, const std::string &content)
+    {
+        // Swapped in whole, so the live server never serves half a file
+        AtomicFile file(path);
+        return file.isOpen() && file.write(content.data(), content.size()) && file.commit();
+    }
+
+    // Whether renders also go to disk, the live server is served from memory either way
+    std::atomic<bool> filesWritten{true};
+
+    std::mutex pageMutex;
+    StandRenderer standRenderer = StandRenderer::Auto;
+    // The page only changes with the renderer, so it is built once per airport
+    std::map<std::string, LiveReloadServer::Body> pages;
+    // Airports whose page is on disk
+    std::set<std::string> pagesWritten;
+
+    LiveReloadServer::Body mapPage(const std::string &icao)
+    {
+        std::lock_guard<std::mutex> lock(pageMutex);
+        LiveReloadServer::Body &page = pages[icao];
+        if (page)
+            return page;
+
+        auto now = std::chrono::system_clock::now();
+        auto timestamp = std::chrono::duration_cast<std::chrono::seconds>(now.time_since_epoch()).count();
+
+        std::string html;
+        html += pageHead;
+        html += icao;
+        html += pageStyle;
+        html += "        var DATA_FILE = ";
+        appendString(html, icao + "_stands.json");
+        html += ";\n        var DELTA_FILE = ";
+        appendString(html, icao + "_delta.json");
+        html += ";\n        var STAND_RENDERER = ";
+        appendString(html, standRendererName(standRenderer));
+        html += ";\n";
+        html += pageScript;
+        html += pageFoot;
+        html += std::to_string(timestamp);
+        html += pageEnd;
+        page = std::make_shared<const std::string>(std::move(html));
+        return page;
+    }
+
+    // Written once per session (and again only if the file went away)
+    bool writeMapPage(const std::string &icao, const std::string &page)
+    {
+        std::lock_guard<std::mutex> lock(pageMutex);
+        std::string path = icao + "_map.html";
+        if (pagesWritten.count(icao) && std::filesystem::exists(path))
+            return true;
+        if (!writeFile(path, page))
+            return false;
+        pagesWritten.insert(icao);
+        return true;
+    }
+
+    // Stand rows by name as last written for each airport, deltas are taken against it
+    struct RenderedStands
+    {
+        uint64_t revision = 0;
+        // The stands file as published, rows maps each stand to its slice of it
+        std::shared_ptr<const std::string> text;
+        std::unordered_map<std::string, std::pair<size_t, size_t>> rows;
+
+        std::string_view row(const std::pair<size_t, size_t> &slice) const
+        {
+            return std::string_view(*text).substr(slice.first, slice.second);
+        }
+        Palettes palettes;
+        // Bit of each stand in the label sets, kept for the session like the palettes
+        std::unordered_map<std::string, uint32_t> labelSlots;
+    };
+
+    std::mutex renderedMutex;
+    std::map<std::string, RenderedStands> rendered;
+    // Tells the page a delta from another run does not apply to what it has drawn
+    const std::string sessionId = std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count());
+
+    // <ICAO>_stands.json: {session, revision, stands: [rows], "bounds" or "single", palettes, labels}
+    // <ICAO>_delta.json: {session, from, to, palettes, labels, changed: [rows], removed: [names]}
+    // Rows go straight into the stands file, the keys that depend on every stand follow them.
+    // Row layout: see decodeStand in the page script. The caller holds renderedMutex.
+    RenderedStands renderMapData(const StandTable &stands, const std::string &icao, std::vector<std::string> *skipped, const std::shared_ptr<std::string> &data, std::string &delta)
+    {
+        // Bounds of all stands so the page can fit the map to show them all
+        int validStands = 0;
+        double minLat = 1e9, maxLat = -1e9, minLon = 1e9, maxLon = -1e9;
+        double firstLat = 0, firstLon = 0;
+
+        // Without an earlier render the delta is empty and the page loads the full data
+        auto previous = rendered.find(icao);
+        RenderedStands current;
+        current.revision = stands.revision();
+        current.text = data;
+        std::string &json = *data;
+        current.palettes = previous != rendered.end() ? previous->second.palettes : initialPalettes();
+        if (previous != rendered.end())
+            current.labelSlots = previous->second.labelSlots;
+        std::vector<LabelBox> labels;
+        labels.reserve(stands.size());
+        std::array<std::vector<uint32_t>, colorModeCount> counts;
+        std::optional<std::pair<int, int>> priorityRange;
+        // Sized from the last render, so the file is written without reallocating
+        current.rows.reserve(stands.size());
+        json.reserve(previous != rendered.end() ? previous->second.text->size() + previous->second.text->size() / 8 : stands.size() * 160 + 1024);
+        json += "{\"session\":";
+        json += sessionId;
+        json += ",\"revision\":";
+        appendInteger(json, static_cast<long long>(current.revision));
+        json += ",\n\"stands\":[";
+        for (uint32_t row : stands)
+        {
+            if (!stands.hasCoordinates(row))
+            {
+                if (skipped)
+                    skipped->push_back(stands.name(row));
+                continue;
+            }
+            double lat = stands.lat(row);
+            double lon = stands.lon(row);
+            minLat = std::min(minLat, lat);
+            maxLat = std::max(maxLat, lat);
+            minLon = std::min(minLon, lon);
+            maxLon = std::max(maxLon, lon);
+            if (validStands == 0)
+            {
+                firstLat = lat;
+                firstLon = lon;
+            }
+            validStands++;
+
+            const std::string &name = stands.name(row);
+            auto slot = current.labelSlots.emplace(name, static_cast<uint32_t>(current.labelSlots.size())).first->second;
+            labels.push_back(labelBox(slot, name, lat, lon));
+
+            json += validStands == 1 ? "\n" : ",\n";
+            size_t begin = json.size();
+            ColorIndices colors = appendStand(json, stands, row, current.palettes, slot);
+            current.rows.emplace(name, std::make_pair(begin, json.size() - begin));
+            for (size_t mode = 0; mode < colorModeCount; mode++)
+            {
+                if (counts[mode].size() <= colors[mode])
+                    counts[mode].resize(colors[mode] + 1);
+                counts[mode][colors[mode]]++;
+            }
+            if (std::optional<int> priority = stands.priority(row))
+                priorityRange = priorityRange ? std::make_pair(std::min(priorityRange->first, *priority), std::max(priorityRange->second, *priority)) : std::make_pair(*priority, *priority);
+        }
+
+        // Both depend on every stand, the delta carries them whole too
+        std::string overview;
+        appendPalettes(overview, current.palettes, counts, priorityRange);
+        overview += ",\n";
+        appendLabels(overview, labels, static_cast<uint32_t>(current.labelSlots.size()));
+
+        json += "\n]";
+        if (validStands == 1)
+        {
+            json += ",\"single\":[";
+            appendNumber(json, firstLat);
+            json += ',';
+            appendNumber(json, firstLon);
+            json += ']';
+        }
+        else if (validStands > 1)
+        {
+            json += ",\"bounds\":[[";
+            appendNumber(json, minLat);
+            json += ',';
+            appendNumber(json, minLon);
+            json += "],[";
+            appendNumber(json, maxLat);
+            json += ',';
+            appendNumber(json, maxLon);
+            json += "]]";
+        }
+        json += ',';
+        json += overview;
+        json += "}\n";
+
+        delta.reserve(overview.size() + 1024);
+        delta += "{\"session\":";
+        delta += sessionId;
+        delta += ",\"from\":";
+        if (previous != rendered.end())
+            appendInteger(delta, static_cast<long long>(previous->second.revision));
+        else
+            delta += "null";
+        delta += ",\"to\":";
+        appendInteger(delta, static_cast<long long>(current.revision));
+        delta += ',';
+        delta += overview;
+        delta += ",\"changed\":[";
+        if (previous != rendered.end())
+        {
+            const RenderedStands &old = previous->second;
+            bool first = true;
+            for (const auto &[name, slice] : current.rows)
+            {
+                auto oldRow = old.rows.find(name);
+                if (oldRow != old.rows.end() && old.row(oldRow->second) == current.row(slice))
+                    continue;
+                delta += first ? "\n" : ",\n";
+                delta += current.row(slice);
+                first = false;
+            }
+            delta += "],\"removed\":[";
+            first = true;
+            for (const auto &entry : old.rows)
+            {
+                if (current.rows.count(entry.first))
+                    continue;
+                if (!first)
+                    delta += ',';
+                appendString(delta, entry.first);
+                first = false;
+            }
+        }
+        else
+        {
+            delta += "],\"removed\":[";
+        }
+        delta += "]}\n";
+        return current;
+    }
+}
+
+bool writeMap(const StandTable &stands, const std::string &icao, std::vector<std::string> *skipped)
+{
+    LiveReloadServer::Body page = mapPage(icao);
+    auto data = std::make_shared<std::string>();
+    auto delta = std::make_shared<std::string>();
+    // Held until the render is out, so every delta starts from what was published
+    std::lock_guard<std::mutex> lock(renderedMutex);
+    RenderedStands current = renderMapData(stands, icao, skipped, data, *delta);
+
+    // The delta goes first: a page fetches it once it sees the data file change
+    if (filesWritten.load() && (!writeMapPage(icao, *page) || !writeFile(icao + "_delta.json", *delta) || !writeFile(icao + "_stands.json", *data)))
+        return false;
+    rendered[icao] = std::move(current);
+    if (g_liveServer && g_liveServer->running())
+        g_liveServer->publish({{icao + "_map.html", page}, {icao + "_delta.json", delta}, {icao + "_stands.json", data}}, true);
+    return true;
+}
+
+void setMapFilesWritten(bool written)
+{
+    filesWritten.store(written);
+}
+
+bool mapFilesWritten()
+{
+    return filesWritten.load();
+}
+
+void setMapStandRenderer(StandRenderer renderer)
+{
+    std::lock_guard<std::mutex> lock(pageMutex);
+    if (renderer == standRenderer)
+        return;
+    standRenderer = renderer;
+    // Rebuilt and rewritten by the next render
+    pages.clear();
+    pagesWritten.clear();
+}
+
+StandRenderer mapStandRenderer()
+{
+    std::lock_guard<std::mutex> lock(pageMutex);
+    return standRenderer;
+}
+
+const char *standRendererName(StandRenderer renderer)
+{
+    switch (renderer)
+    {
+    case StandRenderer::Svg:
+        return "svg";
+    case StandRenderer::Canvas:
+        return "canvas";
+    default:
+        return "auto";
+    }
+}
+
+void generateMap(const StandTable &stands, const std::string &icao, bool openBrowser)
+{
+    std::string filename = icao + "_map.html";
+    // Started first so this render is published to it straight from memory
+    if (!stands.empty() && !g_liveServer)
+    {
+        g_liveServer = std::make_unique<LiveReloadServer>();
+        if (g_liveServer->start())
+            std::cout << GREEN << "Live reload server started at http://localhost:" << g_liveServer->getPort() << RESET << std::endl;
+        else
+            std::cout << RED << "Could not start the live reload server." << RESET << std::endl;
+    }
+
+    std::vector<std::string> skipped;
+    if (!writeMap(stands, icao, &skipped))
+    {
+        std::cout << RED << "Error creating HTML file." << RESET << std::endl;
+        return;
+    }
+    for (const std::string &standName : skipped)
+    {
+        std::cout << YELLOW << "Warning: Invalid coordinates for stand " << standName << RESET << std::endl;
+    }
+
+    if (!stands.empty())
+    {
+        if (mapFilesWritten())
+        {
+            std::cout << GREEN << "HTML map generated: " << filename << RESET << std::endl;
+            // Picks up edits made to the files by hand
+            g_liveServer->watch(filename, false);
+            g_liveServer->watch(icao + "_stands.json", true);
+            g_liveServer->watch(icao + "_delta.json", false);
+        }
+        else if (!g_liveServer->running())
+        {
+            std::cout << RED << "Map files are off and the live reload server is not running, nothing to show." << RESET << std::endl;
+            return;
+        }
+        else
+            std::cout << GREEN << "HTML map rendered in memory (map files are off)" << RESET << std::endl;
 
         if (openBrowser)
         {
@@ -886,14 +1650,16 @@ void generateMap(const nlohmann::ordered_json &configJson, const std::string &ic
             ShellExecuteA(NULL, "open", localhost_url.c_str(), NULL, NULL, SW_SHOWNORMAL);
             std::cout << "Map opened at " << localhost_url << std::endl;
 #else
+            // Through the server: browsers refuse to fetch the stands file from file://
+            std::string localhost_url = "http://localhost:" + std::to_string(g_liveServer->getPort()) + "/" + filename;
             // Try to open with the platform default opener in background so it doesn't block
 #if defined(__APPLE__)
-            std::string openCmd = "open \"" + filename + "\" &";
+            std::string openCmd = "open \"" + localhost_url + "\" &";
 #else
-            std::string openCmd = "xdg-open \"" + filename + "\" &";
+            std::string openCmd = "xdg-open \"" + localhost_url + "\" &";
 #endif
             std::system(openCmd.c_str());
-            std::cout << "Map generated at " << filename << std::endl;
+            std::cout << "Map opened at " << localhost_url << std::endl;
 #endif
         }
     }
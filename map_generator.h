@@ -1,5 +1,28 @@
 #pragma once
 #include <string>
-#include "nlohmann/json.hpp"
+#include <vector>
+#include "stand_table.h"
 
-void generateMap(const nlohmann::ordered_json &configJson, const std::string &icao, bool openBrowser = true);
+// How the page draws the stands: one SVG shape and label element per stand, or all of
+// them on a single canvas. Auto picks the canvas from 1000 stands on.
+enum class StandRenderer
+{
+    Auto,
+    Svg,
+    Canvas
+};
+
+// Renders the page (rebuilt only when the renderer changes), the stand data and the delta since the
+// previous render in memory. They are published to the live reload server when it
+// runs and, unless map files are off, written to <ICAO>_map.html, <ICAO>_stands.json
+// and <ICAO>_delta.json. Safe to call from a background thread.
+// Stands without coordinates are left out and, if asked, listed in skipped.
+bool writeMap(const StandTable &stands, const std::string &icao, std::vector<std::string> *skipped = nullptr);
+// Map files are written by default; without them the map only lives in the server
+void setMapFilesWritten(bool written);
+bool mapFilesWritten();
+// A change applies to pages opened after the next render
+void setMapStandRenderer(StandRenderer renderer);
+StandRenderer mapStandRenderer();
+const char *standRendererName(StandRenderer renderer);
+void generateMap(const StandTable &stands, const std::string &icao, bool openBrowser = true);
@@ -0,0 +1,221 @@
+#include "overlap_engine.h"
+#include "spatial_index.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <unordered_map>
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#include <immintrin.h>
+#define OVERLAP_HAVE_AVX2 1
+#endif
+
+namespace
+{
+    constexpr double earthRadius = 6371008.8;
+    constexpr double pi = 3.14159265358979323846;
+    // The projection drifts slightly away from the mean latitude, so the SIMD pass
+    // keeps pairs up to 1% beyond touching and the exact distance decides
+    constexpr double slack = 1.01 * 1.01;
+
+    // Stand circles projected to meters around the mean latitude, sorted by grid cell
+    struct Points
+    {
+        std::vector<double> x;
+        std::vector<double> y;
+        std::vector<double> r;
+        std::vector<uint32_t> row;
+    };
+
+    // Appends every j in [begin, end) whose circle intersects (xi, yi, ri)
+    void narrowScalar(const Points &points, size_t begin, size_t end, double xi, double yi, double ri, std::vector<uint32_t> &out)
+    {
+        for (size_t j = begin; j < end; j++)
+        {
+            double dx = points.x[j] - xi;
+            double dy = points.y[j] - yi;
+            double reach = points.r[j] + ri;
+            if (dx * dx + dy * dy < reach * reach * slack)
+                out.push_back(static_cast<uint32_t>(j));
+        }
+    }
+
+#ifdef OVERLAP_HAVE_AVX2
+    __attribute__((target("avx2"))) void narrowAvx2(const Points &points, size_t begin, size_t end, double xi, double yi, double ri,
+                                                    std::vector<uint32_t> &out)
+    {
+        const __m256d cx = _mm256_set1_pd(xi);
+        const __m256d cy = _mm256_set1_pd(yi);
+        const __m256d cr = _mm256_set1_pd(ri);
+        const __m256d margin = _mm256_set1_pd(slack);
+        size_t j = begin;
+        for (; j + 4 <= end; j += 4)
+        {
+            __m256d dx = _mm256_sub_pd(_mm256_loadu_pd(&points.x[j]), cx);
+            __m256d dy = _mm256_sub_pd(_mm256_loadu_pd(&points.y[j]), cy);
+            __m256d reach = _mm256_add_pd(_mm256_loadu_pd(&points.r[j]), cr);
+            __m256d d2 = _mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy));
+            int mask = _mm256_movemask_pd(_mm256_cmp_pd(d2, _mm256_mul_pd(_mm256_mul_pd(reach, reach), margin), _CMP_LT_OQ));
+            while (mask)
+            {
+                int lane = __builtin_ctz(mask);
+                out.push_back(static_cast<uint32_t>(j + lane));
+                mask &= mask - 1;
+            }
+        }
+        narrowScalar(points, j, end, xi, yi, ri, out);
+    }
+#endif
+
+    using NarrowPhase = void (*)(const Points &, size_t, size_t, double, double, double, std::vector<uint32_t> &);
+
+    NarrowPhase pickNarrowPhase()
+    {
+#ifdef OVERLAP_HAVE_AVX2
+        if (__builtin_cpu_supports("avx2"))
+            return narrowAvx2;
+#endif
+        return narrowScalar;
+    }
+
+    uint64_t cellKey(int64_t x, int64_t y)
+    {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(y)) << 32) | static_cast<uint32_t>(x);
+    }
+}
+
+bool blocksEachOther(const StandTable &stands, uint32_t a, uint32_t b)
+{
+    auto lists = [&stands](uint32_t owner, uint32_t other)
+    {
+        for (uint32_t id : stands.list(stands.block(owner)))
+        {
+            if (stands.string(id) == stands.name(other))
+                return true;
+        }
+        return false;
+    };
+    return lists(a, b) || lists(b, a);
+}
+
+std::vector<StandConflict> findOverlaps(const StandTable &stands)
+{
+    std::vector<StandConflict> conflicts;
+
+    // Gather positioned stands, projected to meters around their mean latitude
+    std::vector<uint32_t> rows;
+    double meanLat = 0;
+    double maxRadius = 0;
+    for (uint32_t row : stands)
+    {
+        if (!stands.hasCoordinates(row))
+            continue;
+        rows.push_back(row);
+        meanLat += stands.lat(row);
+        maxRadius = std::max(maxRadius, stands.standRadius(row));
+    }
+    if (rows.size() < 2)
+        return conflicts;
+    meanLat /= rows.size();
+    const double metersPerRadian = earthRadius;
+    const double lonScale = std::cos(meanLat * pi / 180);
+    // Two circles can only meet if their cells are neighbours
+    const double cellSize = std::max(1.0, 2 * maxRadius * 1.01);
+
+    struct Keyed
+    {
+        int64_t cx;
+        int64_t cy;
+        uint32_t row;
+        double x;
+        double y;
+    };
+    std::vector<Keyed> keyed;
+    keyed.reserve(rows.size());
+    for (uint32_t row : rows)
+    {
+        double x = stands.lon(row) * pi / 180 * lonScale * metersPerRadian;
+        double y = stands.lat(row) * pi / 180 * metersPerRadian;
+        keyed.push_back({static_cast<int64_t>(std::floor(x / cellSize)), static_cast<int64_t>(std::floor(y / cellSize)), row, x, y});
+    }
+    std::sort(keyed.begin(), keyed.end(), [](const Keyed &a, const Keyed &b)
+              { return a.cy != b.cy ? a.cy < b.cy : a.cx != b.cx ? a.cx < b.cx : a.row < b.row; });
+
+    // SoA copy in cell order, each cell is one contiguous range
+    Points points;
+    size_t count = keyed.size();
+    points.x.resize(count);
+    points.y.resize(count);
+    points.r.resize(count);
+    points.row.resize(count);
+    std::unordered_map<uint64_t, std::pair<size_t, size_t>> cells;
+    cells.reserve(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        points.x[i] = keyed[i].x;
+        points.y[i] = keyed[i].y;
+        points.r[i] = stands.standRadius(keyed[i].row);
+        points.row[i] = keyed[i].row;
+        auto &range = cells.try_emplace(cellKey(keyed[i].cx, keyed[i].cy), i, i).first->second;
+        range.second = i + 1;
+    }
+
+    NarrowPhase narrow = pickNarrowPhase();
+    std::vector<uint32_t> hits;
+    // Half neighbourhood so each pair of cells is visited once
+    const int64_t neighbours[4][2] = {{1, 0}, {-1, 1}, {0, 1}, {1, 1}};
+    for (size_t i = 0; i < count; i++)
+    {
+        hits.clear();
+        int64_t cx = keyed[i].cx;
+        int64_t cy = keyed[i].cy;
+        // Own cell: only later points, the earlier ones already checked against i
+        const auto &own = cells[cellKey(cx, cy)];
+        narrow(points, i + 1, own.second, points.x[i], points.y[i], points.r[i], hits);
+        for (const auto &offset : neighbours)
+        {
+            auto cell = cells.find(cellKey(cx + offset[0], cy + offset[1]));
+            if (cell != cells.end())
+                narrow(points, cell->second.first, cell->second.second, points.x[i], points.y[i], points.r[i], hits);
+        }
+        for (uint32_t j : hits)
+        {
+            uint32_t a = points.row[i];
+            uint32_t b = points.row[j];
+            // Same great-circle distance as the spatial index, so add/copy warnings agree
+            double distance = distanceMeters(stands.lat(a), stands.lon(a), stands.lat(b), stands.lon(b));
+            if (distance >= points.r[i] + points.r[j] || blocksEachOther(stands, a, b))
+                continue;
+            conflicts.push_back({a, b, distance, points.r[i] + points.r[j] - distance});
+        }
+    }
+    return conflicts;
+}
+
+// Quotes a CSV field when it holds a separator or a quote
+static std::string csvField(const std::string &value)
+{
+    if (value.find_first_of(",\"\n") == std::string::npos)
+        return value;
+    std::string quoted = "\"";
+    for (char c : value)
+    {
+        if (c == '"')
+            quoted += '"';
+        quoted += c;
+    }
+    return quoted + "\"";
+}
+
+bool exportOverlaps(const StandTable &stands, const std::vector<StandConflict> &conflicts, const std::string &path)
+{
+    std::ofstream file(path);
+    if (!file)
+        return false;
+    file << "stand_a,stand_b,distance_m,overlap_m\n";
+    for (const auto &conflict : conflicts)
+    {
+        file << csvField(stands.name(conflict.a)) << "," << csvField(stands.name(conflict.b)) << "," << formatNumber(std::round(conflict.distance * 100) / 100)
+             << "," << formatNumber(std::round(conflict.overlap * 100) / 100) << "\n";
+    }
+    return static_cast<bool>(file);
+}
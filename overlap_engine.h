@@ -0,0 +1,25 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "stand_table.h"
+
+struct StandConflict
+{
+    uint32_t a; // rows
+    uint32_t b;
+    double distance; // center to center, meters
+    double overlap;  // sum of radii minus distance, meters
+};
+
+// True when either stand lists the other in its Block array
+bool blocksEachOther(const StandTable &stands, uint32_t a, uint32_t b);
+
+// Every pair of intersecting stand circles, except pairs excluded through Block.
+// Broad phase is a sorted spatial hash over SoA positions, narrow phase compares
+// squared equirectangular distances four at a time with AVX2 when the CPU has it;
+// the few pairs it keeps are confirmed with the great-circle distance.
+std::vector<StandConflict> findOverlaps(const StandTable &stands);
+
+// Writes the conflicts as CSV (stand_a,stand_b,distance_m,overlap_m)
+bool exportOverlaps(const StandTable &stands, const std::vector<StandConflict> &conflicts, const std::string &path);
@@ -0,0 +1,97 @@
+#include "render_scheduler.h"
+#include "map_generator.h"
+#include "utils.h"
+#include <iostream>
+
+RenderScheduler::RenderScheduler(std::chrono::milliseconds debounce) : debounce_(debounce)
+{
+    worker_ = std::thread([this]
+                          { run(); });
+}
+
+RenderScheduler::~RenderScheduler()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    worker_.join();
+}
+
+void RenderScheduler::markDirty(const StandTable &stands, const std::string &icao)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stands.revision() == lastRevision_ && icao == lastIcao_)
+            return;
+        lastRevision_ = stands.revision();
+        lastIcao_ = icao;
+    }
+    // The copy is made outside the lock, the worker only ever sees finished snapshots.
+    // Copying when the debounce fires instead would need the prompt thread, which is
+    // blocked reading input by then.
+    auto snapshot = std::make_shared<const StandTable>(stands);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_ = std::move(snapshot);
+        pendingIcao_ = icao;
+        deadline_ = std::chrono::steady_clock::now() + debounce_;
+    }
+    wake_.notify_all();
+}
+
+void RenderScheduler::renderNow(const StandTable &stands, const std::string &icao, bool openBrowser)
+{
+    std::lock_guard<std::mutex> render(renderMutex_);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_.reset();
+        lastRevision_ = stands.revision();
+        lastIcao_ = icao;
+    }
+    generateMap(stands, icao, openBrowser);
+}
+
+void RenderScheduler::setDebounce(std::chrono::milliseconds debounce)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    debounce_ = debounce;
+}
+
+std::chrono::milliseconds RenderScheduler::debounce() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return debounce_;
+}
+
+void RenderScheduler::run()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true)
+    {
+        wake_.wait(lock, [this]
+                   { return pending_ || stopping_; });
+        if (!pending_)
+            return;
+        // Every new request pushes the deadline back; on shutdown the last one is written at once
+        while (!stopping_ && std::chrono::steady_clock::now() < deadline_)
+            wake_.wait_until(lock, deadline_);
+
+        lock.unlock();
+        {
+            std::lock_guard<std::mutex> render(renderMutex_);
+            std::shared_ptr<const StandTable> snapshot;
+            std::string icao;
+            {
+                std::lock_guard<std::mutex> take(mutex_);
+                snapshot = std::move(pending_);
+                icao = pendingIcao_;
+            }
+            // renderNow may have taken over in the meantime
+            if (snapshot && !writeMap(*snapshot, icao))
+                std::cout << RED << "Error writing " << icao << "_map.html in the background." << RESET << std::endl;
+        }
+        lock.lock();
+    }
+}
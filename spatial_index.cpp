@@ -0,0 +1,198 @@
+#include "spatial_index.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    constexpr double cellDegrees = 0.001; // about 110 m of latitude
+    constexpr double earthRadius = 6371008.8;
+    constexpr double pi = 3.14159265358979323846;
+    // Shortest meridian degree, keeps latitude ranges conservative
+    constexpr double metersPerDegreeLat = 110574;
+    constexpr double metersPerDegreeLon = 111320;
+
+    double radians(double degrees) { return degrees * pi / 180; }
+
+    // Degrees of longitude covered by meters at the worst latitude of the range
+    double lonSpan(double lat, double latSpan, double meters)
+    {
+        double worst = std::min(89.9, std::fabs(lat) + latSpan);
+        return meters / (metersPerDegreeLon * std::cos(radians(worst)));
+    }
+
+    void sortHits(std::vector<SpatialIndex::Hit> &hits)
+    {
+        std::sort(hits.begin(), hits.end(), [](const SpatialIndex::Hit &a, const SpatialIndex::Hit &b)
+                  { return a.distance < b.distance || (a.distance == b.distance && a.id < b.id); });
+    }
+}
+
+double distanceMeters(double lat1, double lon1, double lat2, double lon2)
+{
+    // Haversine
+    double dLat = radians(lat2 - lat1);
+    double dLon = radians(lon2 - lon1);
+    double a = std::sin(dLat / 2) * std::sin(dLat / 2) +
+               std::cos(radians(lat1)) * std::cos(radians(lat2)) * std::sin(dLon / 2) * std::sin(dLon / 2);
+    return 2 * earthRadius * std::asin(std::min(1.0, std::sqrt(a)));
+}
+
+uint64_t SpatialIndex::cellKey(int32_t x, int32_t y)
+{
+    return (static_cast<uint64_t>(static_cast<uint32_t>(y)) << 32) | static_cast<uint32_t>(x);
+}
+
+int32_t SpatialIndex::cellIndex(double degrees)
+{
+    return static_cast<int32_t>(std::floor(degrees / cellDegrees));
+}
+
+void SpatialIndex::clear()
+{
+    entries_.clear();
+    cells_.clear();
+    size_ = 0;
+    maxRadius_ = 0;
+    minX_ = minY_ = INT32_MAX;
+    maxX_ = maxY_ = INT32_MIN;
+}
+
+void SpatialIndex::insert(uint32_t id, double lat, double lon, double radius)
+{
+    erase(id);
+    if (id >= entries_.size())
+        entries_.resize(id + 1);
+    int32_t x = cellIndex(lon);
+    int32_t y = cellIndex(lat);
+    Entry &entry = entries_[id];
+    entry = {lat, lon, radius, cellKey(x, y), true};
+    cells_[entry.cell].push_back(id);
+    size_++;
+    maxRadius_ = std::max(maxRadius_, radius);
+    minX_ = std::min(minX_, x);
+    maxX_ = std::max(maxX_, x);
+    minY_ = std::min(minY_, y);
+    maxY_ = std::max(maxY_, y);
+}
+
+void SpatialIndex::erase(uint32_t id)
+{
+    if (id >= entries_.size() || !entries_[id].present)
+        return;
+    Entry &entry = entries_[id];
+    auto cell = cells_.find(entry.cell);
+    std::vector<uint32_t> &ids = cell->second;
+    *std::find(ids.begin(), ids.end(), id) = ids.back();
+    ids.pop_back();
+    if (ids.empty())
+        cells_.erase(cell);
+    entry.present = false;
+    size_--;
+}
+
+template <typename Visit>
+void SpatialIndex::forEachCandidate(double lat, double lon, double reach, Visit &&visit) const
+{
+    if (size_ == 0)
+        return;
+    double latSpan = reach / metersPerDegreeLat;
+    double lonDegrees = lonSpan(lat, latSpan, reach);
+    int64_t x0 = std::max<int64_t>(cellIndex(lon - lonDegrees), minX_);
+    int64_t x1 = std::min<int64_t>(cellIndex(lon + lonDegrees), maxX_);
+    int64_t y0 = std::max<int64_t>(cellIndex(lat - latSpan), minY_);
+    int64_t y1 = std::min<int64_t>(cellIndex(lat + latSpan), maxY_);
+    if (x0 > x1 || y0 > y1)
+        return;
+
+    // A huge reach touches more cells than there are entries, scan the entries instead
+    if (static_cast<double>(x1 - x0 + 1) * static_cast<double>(y1 - y0 + 1) > static_cast<double>(cells_.size()))
+    {
+        for (const auto &[key, ids] : cells_)
+        {
+            int32_t x = static_cast<int32_t>(static_cast<uint32_t>(key));
+            int32_t y = static_cast<int32_t>(key >> 32);
+            if (x < x0 || x > x1 || y < y0 || y > y1)
+                continue;
+            for (uint32_t id : ids)
+                visit(id);
+        }
+        return;
+    }
+    for (int64_t y = y0; y <= y1; y++)
+    {
+        for (int64_t x = x0; x <= x1; x++)
+        {
+            auto cell = cells_.find(cellKey(static_cast<int32_t>(x), static_cast<int32_t>(y)));
+            if (cell == cells_.end())
+                continue;
+            for (uint32_t id : cell->second)
+                visit(id);
+        }
+    }
+}
+
+std::vector<SpatialIndex::Hit> SpatialIndex::nearest(double lat, double lon, size_t count) const
+{
+    std::vector<Hit> hits;
+    if (count == 0 || size_ == 0)
+        return hits;
+    // Widen the search radius until it holds enough centers, every center outside
+    // the final radius is then farther than the count-th closest one
+    double reach = cellDegrees * metersPerDegreeLat;
+    while (true)
+    {
+        hits.clear();
+        forEachCandidate(lat, lon, reach, [&](uint32_t id)
+                         {
+            const Entry &entry = entries_[id];
+            double distance = distanceMeters(lat, lon, entry.lat, entry.lon);
+            if (distance <= reach)
+                hits.push_back({id, distance}); });
+        if (hits.size() >= count || hits.size() == size_)
+            break;
+        reach *= 4;
+        if (reach > 2 * pi * earthRadius)
+        {
+            // Antimeridian or polar corner cases, fall back to every entry
+            hits.clear();
+            for (uint32_t id = 0; id < entries_.size(); id++)
+            {
+                if (entries_[id].present)
+                    hits.push_back({id, distanceMeters(lat, lon, entries_[id].lat, entries_[id].lon)});
+            }
+            break;
+        }
+    }
+    sortHits(hits);
+    if (hits.size() > count)
+        hits.resize(count);
+    return hits;
+}
+
+std::vector<SpatialIndex::Hit> SpatialIndex::within(double lat, double lon, double radius) const
+{
+    std::vector<Hit> hits;
+    forEachCandidate(lat, lon, radius, [&](uint32_t id)
+                     {
+        const Entry &entry = entries_[id];
+        double distance = distanceMeters(lat, lon, entry.lat, entry.lon);
+        if (distance <= radius)
+            hits.push_back({id, distance}); });
+    sortHits(hits);
+    return hits;
+}
+
+std::vector<SpatialIndex::Hit> SpatialIndex::overlapping(double lat, double lon, double radius, uint32_t exclude) const
+{
+    std::vector<Hit> hits;
+    forEachCandidate(lat, lon, radius + maxRadius_, [&](uint32_t id)
+                     {
+        if (id == exclude)
+            return;
+        const Entry &entry = entries_[id];
+        double distance = distanceMeters(lat, lon, entry.lat, entry.lon);
+        if (distance < radius + entry.radius)
+            hits.push_back({id, distance}); });
+    sortHits(hits);
+    return hits;
+}
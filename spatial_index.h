@@ -0,0 +1,59 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// Great-circle distance in meters
+double distanceMeters(double lat1, double lon1, double lat2, double lon2);
+
+// Uniform geographic grid over circles (center + radius in meters), keyed by id.
+// Cells are a fixed size in degrees; query ranges are widened per latitude so they
+// stay conservative, and every candidate is checked with the exact distance.
+class SpatialIndex
+{
+public:
+    static constexpr uint32_t none = UINT32_MAX;
+
+    struct Hit
+    {
+        uint32_t id;
+        double distance; // center to center, meters
+    };
+
+    void clear();
+    // Adds the circle or moves it if the id is already indexed
+    void insert(uint32_t id, double lat, double lon, double radius);
+    void erase(uint32_t id);
+    size_t size() const { return size_; }
+
+    // Closest centers first
+    std::vector<Hit> nearest(double lat, double lon, size_t count) const;
+    // Centers at most radius meters away, closest first
+    std::vector<Hit> within(double lat, double lon, double radius) const;
+    // Circles intersecting the given one, closest first
+    std::vector<Hit> overlapping(double lat, double lon, double radius, uint32_t exclude = none) const;
+
+private:
+    struct Entry
+    {
+        double lat = 0;
+        double lon = 0;
+        double radius = 0;
+        uint64_t cell = 0;
+        bool present = false;
+    };
+
+    static uint64_t cellKey(int32_t x, int32_t y);
+    static int32_t cellIndex(double degrees);
+    // Calls visit(id) for every entry whose cell may hold a point within reach meters
+    template <typename Visit>
+    void forEachCandidate(double lat, double lon, double reach, Visit &&visit) const;
+
+    std::vector<Entry> entries_;
+    std::unordered_map<uint64_t, std::vector<uint32_t>> cells_;
+    size_t size_ = 0;
+    // Largest radius ever indexed, bounds the search for intersecting circles
+    double maxRadius_ = 0;
+    int32_t minX_ = INT32_MAX, maxX_ = INT32_MIN, minY_ = INT32_MAX, maxY_ = INT32_MIN;
+};
@@ -0,0 +1,976 @@
+#include "stand_table.h"
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstring>
+#include <iterator>
+#include <type_traits>
+
+namespace
+{
+    // Shared by every table, so no two table states ever carry the same revision
+    std::atomic<uint64_t> lastRevision{0};
+
+    // Native-endian helpers for the binary snapshot
+    template <typename T>
+    void putPod(std::string &out, const T &value)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "plain data only");
+        out.append(reinterpret_cast<const char *>(&value), sizeof(T));
+    }
+
+    template <typename T>
+    void putColumn(std::string &out, const std::vector<T> &column, const std::vector<uint32_t> &rows)
+    {
+        for (uint32_t row : rows)
+            putPod(out, column[row]);
+    }
+
+    void putString(std::string &out, const std::string &value)
+    {
+        putPod(out, static_cast<uint32_t>(value.size()));
+        out += value;
+    }
+
+    struct SnapshotReader
+    {
+        const char *data;
+        const char *end;
+        bool ok = true;
+
+        bool has(size_t bytes)
+        {
+            ok = ok && static_cast<size_t>(end - data) >= bytes;
+            return ok;
+        }
+
+        template <typename T>
+        T pod()
+        {
+            T value{};
+            if (has(sizeof(T)))
+            {
+                std::memcpy(&value, data, sizeof(T));
+                data += sizeof(T);
+            }
+            return value;
+        }
+
+        // Sizes come from the file, so the bytes are checked before anything is allocated
+        template <typename T>
+        void column(std::vector<T> &out, size_t count)
+        {
+            ok = ok && count <= static_cast<size_t>(end - data) / sizeof(T);
+            if (!ok)
+            {
+                out.clear();
+                return;
+            }
+            out.resize(count);
+            if (count > 0)
+            {
+                std::memcpy(out.data(), data, sizeof(T) * count);
+                data += sizeof(T) * count;
+            }
+        }
+
+        std::string string()
+        {
+            uint32_t size = pod<uint32_t>();
+            if (!has(size))
+                return std::string();
+            std::string value(data, size);
+            data += size;
+            return value;
+        }
+    };
+
+    bool stringArray(const nlohmann::ordered_json &value, std::vector<std::string> &out)
+    {
+        if (!value.is_array())
+            return false;
+        for (const auto &item : value)
+        {
+            if (!item.is_string())
+                return false;
+        }
+        for (const auto &item : value)
+        {
+            out.push_back(item.get<std::string>());
+        }
+        return true;
+    }
+
+    // JSON integers that fit an int, larger ones are left untyped rather than truncated
+    bool intValue(const nlohmann::ordered_json &value, int &out)
+    {
+        if (value.is_number_unsigned())
+        {
+            if (value.get<uint64_t>() > static_cast<uint64_t>(INT_MAX))
+                return false;
+        }
+        else if (!value.is_number_integer() || value.get<int64_t>() < INT_MIN || value.get<int64_t>() > INT_MAX)
+            return false;
+        out = value.get<int>();
+        return true;
+    }
+
+    bool apronObject(const nlohmann::ordered_json &value, Apron &out)
+    {
+        if (!value.is_object() || !value.contains("Size") || !intValue(value["Size"], out.size))
+            return false;
+        for (auto &[key, item] : value.items())
+        {
+            if (key != "Size" && key != "Coordinates")
+                return false;
+        }
+        return !value.contains("Coordinates") || stringArray(value["Coordinates"], out.coordinates);
+    }
+
+    // Keys in the order toJson writes them, keys it does not type come after all of them
+    const char *const typedKeys[] = {"Coordinates", "Code", "Use", "Schengen", "Callsigns", "Countries",
+                                     "Block", "Remark", "Wingspan", "Priority", "Apron"};
+    constexpr int untypedRank = static_cast<int>(std::size(typedKeys));
+
+    int typedKeyIndex(const std::string &key)
+    {
+        for (int i = 0; i < untypedRank; i++)
+        {
+            if (key == typedKeys[i])
+                return i;
+        }
+        return -1;
+    }
+}
+
+StandRecord StandRecord::fromJson(const nlohmann::ordered_json &standJson, bool *asRead)
+{
+    StandRecord record;
+    std::optional<nlohmann::ordered_json> source;
+    if (!standJson.is_object())
+    {
+        if (asRead)
+            *asRead = false;
+        return record;
+    }
+
+    for (auto &[key, value] : standJson.items())
+    {
+        record.applyField(key, value, asRead ? &source : nullptr);
+    }
+    if (asRead)
+        *asRead = !source;
+    return record;
+}
+
+void StandRecord::applyField(const std::string &key, const nlohmann::ordered_json &value,
+                             std::optional<nlohmann::ordered_json> *source)
+{
+    // Called before this key changes the record: every key so far reads back, so
+    // toJson gives them as read
+    auto flag = [&]()
+    {
+        if (source && !*source)
+            *source = toJson();
+    };
+
+    int index = typedKeyIndex(key);
+    if (index >= 0)
+    {
+        // A repeated key keeps its first position, and a typed key goes before later ones
+        if ((readKeys & (1u << index)) || index < readRank)
+            flag();
+        readKeys |= 1u << index;
+    }
+
+    bool typed = false;
+    if (key == "Coordinates" && value.is_string())
+    {
+        const std::string &text = value.get_ref<const std::string &>();
+        Coordinates parsed;
+        typed = parseCoordinates(text, parsed);
+        if (typed && !formatsAs(parsed, text))
+            flag();
+        if (typed)
+            coordinates = parsed;
+        hasCoordinates = typed;
+    }
+    else if (key == "Code" && value.is_string())
+    {
+        const std::string &text = value.get_ref<const std::string &>();
+        typed = codeIsValid(text);
+        if (typed)
+        {
+            uint8_t mask = codeMask(text);
+            if (codeString(mask) != text)
+                flag();
+            code = mask;
+        }
+    }
+    else if (key == "Use" && value.is_string())
+    {
+        const std::string &text = value.get_ref<const std::string &>();
+        typed = useIsValid(text);
+        if (typed)
+        {
+            uint8_t mask = useMask(text);
+            if (useString(mask) != text)
+                flag();
+            use = mask;
+        }
+    }
+    else if (key == "Schengen" && value.is_boolean())
+    {
+        schengen = value.get<bool>() ? Schengen::Yes : Schengen::No;
+        typed = true;
+    }
+    else if (key == "Callsigns")
+        typed = stringArray(value, callsigns);
+    else if (key == "Countries")
+        typed = stringArray(value, countries);
+    else if (key == "Block")
+        typed = stringArray(value, block);
+    else if (key == "Remark" && value.is_object())
+    {
+        typed = true;
+        for (auto &[remarkKey, remark] : value.items())
+        {
+            typed = typed && remark.is_string();
+        }
+        if (typed)
+        {
+            for (auto &[remarkKey, remark] : value.items())
+            {
+                remarks.emplace_back(remarkKey, remark.get<std::string>());
+            }
+        }
+    }
+    else if (key == "Wingspan" && value.is_number_integer())
+    {
+        int number = 0;
+        typed = intValue(value, number);
+        if (typed)
+            wingspan = number;
+    }
+    else if (key == "Priority" && value.is_number_integer())
+    {
+        int number = 0;
+        typed = intValue(value, number);
+        if (typed)
+            priority = number;
+    }
+    else if (key == "Apron")
+    {
+        Apron parsed;
+        typed = apronObject(value, parsed);
+        // toJson writes Size first and leaves out empty Coordinates
+        if (typed && (value.begin().key() != "Size" || (value.contains("Coordinates") && parsed.coordinates.empty())))
+            flag();
+        if (typed)
+            apron = std::move(parsed);
+    }
+
+    // Typed but left out by toJson
+    if (typed && (value.is_array() || value.is_object()) && value.empty())
+        flag();
+
+    if (!typed)
+        extra[key] = value;
+    readRank = std::max(readRank, typed ? index : untypedRank);
+}
+
+nlohmann::ordered_json StandRecord::toJson() const
+{
+    nlohmann::ordered_json standJson = nlohmann::ordered_json::object();
+    if (hasCoordinates)
+        standJson["Coordinates"] = formatCoordinates(coordinates);
+    if (code)
+        standJson["Code"] = codeString(code);
+    if (use)
+        standJson["Use"] = useString(use);
+    if (schengen != Schengen::Unset)
+        standJson["Schengen"] = schengen == Schengen::Yes;
+    if (!callsigns.empty())
+        standJson["Callsigns"] = callsigns;
+    if (!countries.empty())
+        standJson["Countries"] = countries;
+    if (!block.empty())
+        standJson["Block"] = block;
+    if (!remarks.empty())
+    {
+        for (const auto &[key, value] : remarks)
+        {
+            standJson["Remark"][key] = value;
+        }
+    }
+    if (wingspan)
+        standJson["Wingspan"] = *wingspan;
+    if (priority)
+        standJson["Priority"] = *priority;
+    if (apron)
+    {
+        standJson["Apron"]["Size"] = apron->size;
+        if (!apron->coordinates.empty())
+            standJson["Apron"]["Coordinates"] = apron->coordinates;
+    }
+    for (auto &[key, value] : extra.items())
+    {
+        // A typed value set by an editor wins over a stale untyped one
+        if (!standJson.contains(key))
+            standJson[key] = value;
+    }
+    return standJson;
+}
+
+StandTable::StandTable()
+{
+    clear();
+}
+
+void StandTable::clear()
+{
+    names_.clear();
+    hashes_.clear();
+    keys_.clear();
+    prev_.clear();
+    next_.clear();
+    freeRows_.clear();
+    slots_.clear();
+    order_.clear();
+    spatial_.clear();
+    head_ = npos;
+    tail_ = npos;
+    size_ = 0;
+
+    lat_.clear();
+    lon_.clear();
+    radius_.clear();
+    flags_.clear();
+    code_.clear();
+    use_.clear();
+    schengen_.clear();
+    wingspan_.clear();
+    priority_.clear();
+    callsigns_.clear();
+    countries_.clear();
+    block_.clear();
+    remarks_.clear();
+    cold_.clear();
+
+    strings_.clear();
+    stringIds_.clear();
+    lists_.assign(1, {});
+    listIds_.clear();
+    listIds_[{}] = emptyList;
+    touch();
+}
+
+void StandTable::touch()
+{
+    revision_ = ++lastRevision;
+}
+
+void StandTable::load(const nlohmann::ordered_json &standsJson)
+{
+    clear();
+    if (!standsJson.is_object())
+        return;
+    rehash(standsJson.size() * 2);
+    for (auto &[key, value] : standsJson.items())
+    {
+        bool asRead = true;
+        uint32_t row = insert(key, StandRecord::fromJson(value, &asRead));
+        if (!asRead)
+            setSource(row, value);
+    }
+}
+
+uint64_t StandTable::hashName(const std::string &name)
+{
+    // FNV-1a
+    uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : name)
+    {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+size_t StandTable::findSlot(const std::string &name, uint64_t hash) const
+{
+    size_t mask = slots_.size() - 1;
+    size_t slot = hash & mask;
+    while (slots_[slot] != npos)
+    {
+        uint32_t row = slots_[slot];
+        if (hashes_[row] == hash && names_[row] == name)
+            return slot;
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+uint32_t StandTable::find(const std::string &name) const
+{
+    if (slots_.empty())
+        return npos;
+    return slots_[findSlot(name, hashName(name))];
+}
+
+void StandTable::rehash(size_t capacity)
+{
+    size_t newSize = 16;
+    while (newSize < capacity)
+        newSize <<= 1;
+    if (newSize <= slots_.size())
+        return;
+    slots_.assign(newSize, npos);
+    for (uint32_t row = head_; row != npos; row = next_[row])
+    {
+        indexInsert(row);
+    }
+}
+
+void StandTable::indexInsert(uint32_t row)
+{
+    size_t mask = slots_.size() - 1;
+    size_t slot = hashes_[row] & mask;
+    while (slots_[slot] != npos)
+        slot = (slot + 1) & mask;
+    slots_[slot] = row;
+}
+
+void StandTable::indexErase(uint32_t row)
+{
+    size_t mask = slots_.size() - 1;
+    size_t hole = findSlot(names_[row], hashes_[row]);
+    slots_[hole] = npos;
+    // Backward-shift deletion: pull following entries of the probe run into the hole
+    // so lookups never need tombstones.
+    size_t slot = (hole + 1) & mask;
+    while (slots_[slot] != npos)
+    {
+        size_t home = hashes_[slots_[slot]] & mask;
+        if (((slot - home) & mask) >= ((slot - hole) & mask))
+        {
+            slots_[hole] = slots_[slot];
+            slots_[slot] = npos;
+            hole = slot;
+        }
+        slot = (slot + 1) & mask;
+    }
+}
+
+uint32_t StandTable::allocateRow(const std::string &name)
+{
+    // Keep the load factor under 0.7
+    if ((size_ + 1) * 10 > slots_.size() * 7)
+        rehash(slots_.size() * 2);
+
+    uint32_t row;
+    if (!freeRows_.empty())
+    {
+        row = freeRows_.back();
+        freeRows_.pop_back();
+        names_[row] = name;
+        keys_[row] = ::naturalKey(name);
+    }
+    else
+    {
+        row = static_cast<uint32_t>(names_.size());
+        names_.push_back(name);
+        hashes_.push_back(0);
+        keys_.push_back(::naturalKey(name));
+        prev_.push_back(npos);
+        next_.push_back(npos);
+        lat_.push_back(0);
+        lon_.push_back(0);
+        radius_.push_back(0);
+        flags_.push_back(0);
+        code_.push_back(0);
+        use_.push_back(0);
+        schengen_.push_back(static_cast<int8_t>(Schengen::Unset));
+        wingspan_.push_back(0);
+        priority_.push_back(0);
+        callsigns_.push_back(emptyList);
+        countries_.push_back(emptyList);
+        block_.push_back(emptyList);
+        remarks_.push_back(emptyList);
+        cold_.emplace_back();
+    }
+    hashes_[row] = hashName(name);
+    prev_[row] = tail_;
+    next_[row] = npos;
+    if (tail_ != npos)
+        next_[tail_] = row;
+    else
+        head_ = row;
+    tail_ = row;
+
+    indexInsert(row);
+    order_.emplace_hint(order_.end(), keys_[row], row);
+    size_++;
+    touch();
+    return row;
+}
+
+uint32_t StandTable::insert(const std::string &name, const StandRecord &record)
+{
+    if (contains(name))
+        return npos;
+    uint32_t row = allocateRow(name);
+    assignRecord(row, record);
+    return row;
+}
+
+uint32_t StandTable::insertCopy(const std::string &name, uint32_t sourceRow)
+{
+    if (contains(name))
+        return npos;
+    uint32_t row = allocateRow(name);
+    lat_[row] = lat_[sourceRow];
+    lon_[row] = lon_[sourceRow];
+    radius_[row] = radius_[sourceRow];
+    flags_[row] = flags_[sourceRow];
+    code_[row] = code_[sourceRow];
+    use_[row] = use_[sourceRow];
+    schengen_[row] = schengen_[sourceRow];
+    wingspan_[row] = wingspan_[sourceRow];
+    priority_[row] = priority_[sourceRow];
+    callsigns_[row] = callsigns_[sourceRow];
+    countries_[row] = countries_[sourceRow];
+    block_[row] = block_[sourceRow];
+    remarks_[row] = remarks_[sourceRow];
+    cold_[row] = cold_[sourceRow];
+    if (flags_[row] & HasCoordinates)
+        spatial_.insert(row, lat_[row], lon_[row], standRadius(row));
+    return row;
+}
+
+void StandTable::erase(uint32_t row)
+{
+    indexErase(row);
+    spatial_.erase(row);
+    order_.erase(keys_[row]);
+    if (prev_[row] != npos)
+        next_[prev_[row]] = next_[row];
+    else
+        head_ = next_[row];
+    if (next_[row] != npos)
+        prev_[next_[row]] = prev_[row];
+    else
+        tail_ = prev_[row];
+
+    names_[row].clear();
+    keys_[row].bytes.clear();
+    cold_[row].reset();
+    freeRows_.push_back(row);
+    size_--;
+    touch();
+}
+
+bool StandTable::rename(uint32_t row, const std::string &newName)
+{
+    if (contains(newName))
+        return false;
+    indexErase(row);
+    order_.erase(keys_[row]);
+    names_[row] = newName;
+    hashes_[row] = hashName(newName);
+    keys_[row] = ::naturalKey(newName);
+    indexInsert(row);
+    order_.emplace(keys_[row], row);
+    touch();
+    return true;
+}
+
+std::vector<uint32_t> StandTable::withLetters(uint8_t codeBits, uint8_t useBits) const
+{
+    std::vector<uint32_t> rows;
+    for (const auto &entry : order_)
+    {
+        uint32_t row = entry.second;
+        if ((code_[row] & codeBits) == codeBits && (use_[row] & useBits) == useBits)
+            rows.push_back(row);
+    }
+    return rows;
+}
+
+std::optional<int> StandTable::wingspan(uint32_t row) const
+{
+    if (flags_[row] & HasWingspan)
+        return wingspan_[row];
+    return std::nullopt;
+}
+
+std::optional<int> StandTable::priority(uint32_t row) const
+{
+    if (flags_[row] & HasPriority)
+        return priority_[row];
+    return std::nullopt;
+}
+
+StandRecord StandTable::record(uint32_t row) const
+{
+    StandRecord record;
+    record.hasCoordinates = hasCoordinates(row);
+    record.coordinates = coordinates(row);
+    record.code = code_[row];
+    record.use = use_[row];
+    record.schengen = schengen(row);
+    record.callsigns = listStrings(callsigns_[row]);
+    record.countries = listStrings(countries_[row]);
+    record.block = listStrings(block_[row]);
+    const std::vector<uint32_t> &remarks = lists_[remarks_[row]];
+    for (size_t i = 0; i + 1 < remarks.size(); i += 2)
+    {
+        record.remarks.emplace_back(strings_[remarks[i]], strings_[remarks[i + 1]]);
+    }
+    record.wingspan = wingspan(row);
+    record.priority = priority(row);
+    if (cold_[row])
+    {
+        record.apron = cold_[row]->apron;
+        record.extra = cold_[row]->extra;
+    }
+    return record;
+}
+
+void StandTable::setRecord(uint32_t row, const StandRecord &record)
+{
+    // Editors store the record back even when nothing was changed
+    uint64_t revision = revision_;
+    nlohmann::ordered_json before = toJson(row);
+    std::shared_ptr<const StandCold> cold = cold_[row];
+    assignRecord(row, record);
+    if (toJson(row) == before)
+    {
+        // Same content, so the source read from the file still applies
+        revision_ = revision;
+        cold_[row] = std::move(cold);
+    }
+    else
+        touch();
+}
+
+void StandTable::setSource(uint32_t row, std::optional<nlohmann::ordered_json> source)
+{
+    if (!source && !(cold_[row] && cold_[row]->source))
+        return;
+    StandCold cold = cold_[row] ? *cold_[row] : StandCold{std::nullopt, nlohmann::ordered_json::object(), std::nullopt};
+    cold.source = std::move(source);
+    if (cold.apron || !cold.extra.empty() || cold.source)
+        cold_[row] = std::make_shared<const StandCold>(std::move(cold));
+    else
+        cold_[row].reset();
+}
+
+void StandTable::assignRecord(uint32_t row, const StandRecord &record)
+{
+    uint8_t flags = 0;
+    if (record.wingspan)
+        flags |= HasWingspan;
+    if (record.priority)
+        flags |= HasPriority;
+    flags_[row] = flags;
+    if (record.hasCoordinates)
+        setCoordinates(row, record.coordinates);
+    else
+        spatial_.erase(row);
+
+    code_[row] = record.code;
+    use_[row] = record.use;
+    schengen_[row] = static_cast<int8_t>(record.schengen);
+    wingspan_[row] = record.wingspan.value_or(0);
+    priority_[row] = record.priority.value_or(0);
+    callsigns_[row] = internStrings(record.callsigns);
+    countries_[row] = internStrings(record.countries);
+    block_[row] = internStrings(record.block);
+
+    std::vector<uint32_t> remarks;
+    remarks.reserve(record.remarks.size() * 2);
+    for (const auto &[key, value] : record.remarks)
+    {
+        remarks.push_back(internString(key));
+        remarks.push_back(internString(value));
+    }
+    remarks_[row] = internList(std::move(remarks));
+
+    // Untyped leftovers are dropped once an editor sets the typed value
+    nlohmann::ordered_json extra = record.extra;
+    if (!extra.empty())
+    {
+        const std::pair<const char *, bool> typed[] = {
+            {"Coordinates", record.hasCoordinates}, {"Code", record.code != 0}, {"Use", record.use != 0},
+            {"Schengen", record.schengen != Schengen::Unset}, {"Callsigns", !record.callsigns.empty()},
+            {"Countries", !record.countries.empty()}, {"Block", !record.block.empty()},
+            {"Remark", !record.remarks.empty()}, {"Wingspan", record.wingspan.has_value()},
+            {"Priority", record.priority.has_value()}, {"Apron", record.apron.has_value()}};
+        for (const auto &[key, set] : typed)
+        {
+            if (set)
+                extra.erase(key);
+        }
+    }
+
+    if (record.apron || !extra.empty())
+        cold_[row] = std::make_shared<const StandCold>(StandCold{record.apron, std::move(extra)});
+    else
+        cold_[row].reset();
+}
+
+void StandTable::setCoordinates(uint32_t row, const Coordinates &coordinates)
+{
+    if ((flags_[row] & HasCoordinates) && lat_[row] == coordinates.lat && lon_[row] == coordinates.lon &&
+        radius_[row] == coordinates.radius && ((flags_[row] & HasRadius) != 0) == coordinates.hasRadius &&
+        !(cold_[row] && cold_[row]->extra.contains("Coordinates")))
+        return;
+    lat_[row] = coordinates.lat;
+    lon_[row] = coordinates.lon;
+    radius_[row] = coordinates.radius;
+    flags_[row] = (flags_[row] & ~HasRadius) | HasCoordinates | (coordinates.hasRadius ? HasRadius : 0);
+    spatial_.insert(row, coordinates.lat, coordinates.lon, standRadius(row));
+    if (cold_[row] && (cold_[row]->extra.contains("Coordinates") || cold_[row]->source))
+    {
+        StandCold cold = *cold_[row];
+        cold.extra.erase("Coordinates");
+        cold.source.reset();
+        cold_[row] = std::make_shared<const StandCold>(std::move(cold));
+    }
+    touch();
+}
+
+void StandTable::writeSnapshot(std::string &out) const
+{
+    // Rows are written densely in insertion order, ids are remapped accordingly
+    std::vector<uint32_t> rows(begin(), end());
+    std::vector<uint32_t> dense(names_.size(), npos);
+    for (uint32_t i = 0; i < rows.size(); i++)
+        dense[rows[i]] = i;
+
+    putPod(out, static_cast<uint32_t>(rows.size()));
+    putPod(out, static_cast<uint32_t>(strings_.size()));
+    for (const std::string &value : strings_)
+        putString(out, value);
+    putPod(out, static_cast<uint32_t>(lists_.size()));
+    for (const auto &list : lists_)
+    {
+        putPod(out, static_cast<uint32_t>(list.size()));
+        out.append(reinterpret_cast<const char *>(list.data()), list.size() * sizeof(uint32_t));
+    }
+
+    for (uint32_t row : rows)
+        putString(out, names_[row]);
+    for (uint32_t row : rows)
+        putString(out, keys_[row].bytes);
+    putColumn(out, hashes_, rows);
+    putColumn(out, lat_, rows);
+    putColumn(out, lon_, rows);
+    putColumn(out, radius_, rows);
+    putColumn(out, flags_, rows);
+    putColumn(out, code_, rows);
+    putColumn(out, use_, rows);
+    putColumn(out, schengen_, rows);
+    putColumn(out, wingspan_, rows);
+    putColumn(out, priority_, rows);
+    putColumn(out, callsigns_, rows);
+    putColumn(out, countries_, rows);
+    putColumn(out, block_, rows);
+    putColumn(out, remarks_, rows);
+    for (uint32_t row : rows)
+    {
+        std::string cold;
+        if (cold_[row])
+        {
+            nlohmann::ordered_json coldJson = {{"extra", cold_[row]->extra}};
+            if (cold_[row]->apron)
+                coldJson["apron"] = {{"Size", cold_[row]->apron->size}, {"Coordinates", cold_[row]->apron->coordinates}};
+            if (cold_[row]->source)
+                coldJson["source"] = *cold_[row]->source;
+            cold = coldJson.dump();
+        }
+        putString(out, cold);
+    }
+
+    for (const auto &[key, row] : order_)
+        putPod(out, dense[row]);
+    putPod(out, static_cast<uint32_t>(slots_.size()));
+    for (uint32_t row : slots_)
+        putPod(out, row == npos ? npos : dense[row]);
+}
+
+bool StandTable::readSnapshot(const char *&data, const char *end)
+{
+    clear();
+    SnapshotReader in{data, end};
+    uint32_t count = in.pod<uint32_t>();
+
+    uint32_t stringCount = in.pod<uint32_t>();
+    in.has(stringCount * sizeof(uint32_t));
+    strings_.reserve(stringCount);
+    for (uint32_t i = 0; i < stringCount && in.ok; i++)
+    {
+        strings_.push_back(in.string());
+        stringIds_.emplace(strings_.back(), i);
+    }
+    uint32_t listCount = in.pod<uint32_t>();
+    in.ok = in.ok && listCount > 0;
+    in.has(listCount * sizeof(uint32_t));
+    lists_.clear();
+    listIds_.clear();
+    for (uint32_t i = 0; i < listCount && in.ok; i++)
+    {
+        std::vector<uint32_t> list;
+        in.column(list, in.pod<uint32_t>());
+        for (uint32_t id : list)
+            in.ok = in.ok && id < stringCount;
+        listIds_.emplace(list, i);
+        lists_.push_back(std::move(list));
+    }
+    in.ok = in.ok && !lists_.empty() && lists_[emptyList].empty();
+    in.has(count * 2 * sizeof(uint32_t));
+    if (!in.ok)
+    {
+        clear();
+        return false;
+    }
+
+    names_.reserve(count);
+    keys_.reserve(count);
+    for (uint32_t i = 0; i < count; i++)
+        names_.push_back(in.string());
+    for (uint32_t i = 0; i < count; i++)
+        keys_.push_back(NaturalKey{in.string()});
+    in.column(hashes_, count);
+    in.column(lat_, count);
+    in.column(lon_, count);
+    in.column(radius_, count);
+    in.column(flags_, count);
+    in.column(code_, count);
+    in.column(use_, count);
+    in.column(schengen_, count);
+    in.column(wingspan_, count);
+    in.column(priority_, count);
+    in.column(callsigns_, count);
+    in.column(countries_, count);
+    in.column(block_, count);
+    in.column(remarks_, count);
+    for (const auto *column : {&callsigns_, &countries_, &block_, &remarks_})
+    {
+        for (uint32_t id : *column)
+            in.ok = in.ok && id < listCount;
+    }
+
+    cold_.resize(count);
+    for (uint32_t i = 0; i < count && in.ok; i++)
+    {
+        std::string cold = in.string();
+        if (cold.empty())
+            continue;
+        nlohmann::ordered_json coldJson = nlohmann::ordered_json::parse(cold, nullptr, false);
+        StandCold parsed;
+        if (coldJson.is_discarded() || !coldJson.contains("extra") || !coldJson["extra"].is_object())
+        {
+            in.ok = false;
+            break;
+        }
+        parsed.extra = coldJson["extra"];
+        if (coldJson.contains("apron"))
+        {
+            // Checked like a stand's Apron key, so a damaged value fails the read instead of throwing
+            Apron apron;
+            if (!apronObject(coldJson["apron"], apron))
+            {
+                in.ok = false;
+                break;
+            }
+            parsed.apron = std::move(apron);
+        }
+        if (coldJson.contains("source"))
+            parsed.source = coldJson["source"];
+        cold_[i] = std::make_shared<const StandCold>(std::move(parsed));
+    }
+
+    // Sorted order comes pre-sorted, so every insert lands at the end of the map
+    for (uint32_t i = 0; i < count && in.ok; i++)
+    {
+        uint32_t row = in.pod<uint32_t>();
+        in.ok = in.ok && row < count;
+        if (in.ok)
+            order_.emplace_hint(order_.end(), keys_[row], row);
+    }
+    uint32_t capacity = in.pod<uint32_t>();
+    in.ok = in.ok && (capacity & (capacity - 1)) == 0 && count * 10 <= static_cast<uint64_t>(capacity) * 7;
+    in.column(slots_, in.ok ? capacity : 0);
+    for (uint32_t row : slots_)
+        in.ok = in.ok && (row == npos || row < count);
+    if (!in.ok || order_.size() != count)
+    {
+        clear();
+        return false;
+    }
+
+    prev_.resize(count);
+    next_.resize(count);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        prev_[i] = i == 0 ? npos : i - 1;
+        next_[i] = i + 1 == count ? npos : i + 1;
+    }
+    head_ = count ? 0 : npos;
+    tail_ = count ? count - 1 : npos;
+    size_ = count;
+    // Rebuilding the grid is linear and cheaper than validating a stored one
+    for (uint32_t row = 0; row < count; row++)
+    {
+        if (flags_[row] & HasCoordinates)
+            spatial_.insert(row, lat_[row], lon_[row], standRadius(row));
+    }
+    data = in.data;
+    touch();
+    return true;
+}
+
+uint32_t StandTable::internString(const std::string &value)
+{
+    auto it = stringIds_.find(value);
+    if (it != stringIds_.end())
+        return it->second;
+    uint32_t id = static_cast<uint32_t>(strings_.size());
+    strings_.push_back(value);
+    stringIds_.emplace(value, id);
+    return id;
+}
+
+uint32_t StandTable::internList(std::vector<uint32_t> ids)
+{
+    auto it = listIds_.find(ids);
+    if (it != listIds_.end())
+        return it->second;
+    uint32_t id = static_cast<uint32_t>(lists_.size());
+    lists_.push_back(ids);
+    listIds_.emplace(std::move(ids), id);
+    return id;
+}
+
+uint32_t StandTable::internStrings(const std::vector<std::string> &values)
+{
+    std::vector<uint32_t> ids;
+    ids.reserve(values.size());
+    for (const auto &value : values)
+    {
+        ids.push_back(internString(value));
+    }
+    return internList(std::move(ids));
+}
+
+std::vector<std::string> StandTable::listStrings(uint32_t listId) const
+{
+    std::vector<std::string> values;
+    for (uint32_t id : lists_[listId])
+    {
+        values.push_back(strings_[id]);
+    }
+    return values;
+}
@@ -0,0 +1,279 @@
+#pragma once
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "nlohmann/json.hpp"
+#include "utils.h"
+#include "spatial_index.h"
+
+enum class Schengen : int8_t
+{
+    Unset = -1,
+    No = 0,
+    Yes = 1
+};
+
+struct Apron
+{
+    int size = 0;
+    std::vector<std::string> coordinates;
+};
+
+// One stand, materialized from the table for display and editing
+struct StandRecord
+{
+    bool hasCoordinates = false;
+    Coordinates coordinates;
+    uint8_t code = 0; // one bit per letter, see codeMask
+    uint8_t use = 0;  // one bit per letter, see useMask
+    Schengen schengen = Schengen::Unset;
+    std::vector<std::string> callsigns;
+    std::vector<std::string> countries;
+    std::vector<std::string> block;
+    std::vector<std::pair<std::string, std::string>> remarks;
+    std::optional<int> wingspan;
+    std::optional<int> priority;
+    std::optional<Apron> apron;
+    // Keys the model does not know (or values it cannot type), written back untouched
+    nlohmann::ordered_json extra = nlohmann::ordered_json::object();
+    // Read state of applyField: highest toJson position so far and the typed keys seen
+    int readRank = -1;
+    uint16_t readKeys = 0;
+
+    // A non-object Apron value is kept in extra but still marks an apron stand
+    bool isApron() const { return apron.has_value() || (extra.contains("Apron") && extra["Apron"] != false); }
+
+    // Sets *asRead when toJson would not give standJson back as read
+    static StandRecord fromJson(const nlohmann::ordered_json &standJson, bool *asRead = nullptr);
+    // Types one stand key, values that cannot be typed go to extra. The first key toJson
+    // would not write back as read (letters out of mask order, an empty container, number
+    // text that does not round-trip, a key out of toJson order) sets *source to the keys
+    // read before it; the caller then adds this key and the following ones.
+    void applyField(const std::string &key, const nlohmann::ordered_json &value,
+                    std::optional<nlohmann::ordered_json> *source = nullptr);
+    nlohmann::ordered_json toJson() const;
+};
+
+// Insertion-ordered stand store. Rows keep a stable id for their whole lifetime and
+// are kept as parallel typed columns; names are resolved through an open-addressing
+// (linear probing) hash index. String lists are interned and shared between rows.
+class StandTable
+{
+public:
+    static constexpr uint32_t npos = UINT32_MAX;
+    // List id of the empty list
+    static constexpr uint32_t emptyList = 0;
+
+    // Walks live rows in insertion order
+    class const_iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = uint32_t;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const uint32_t *;
+        using reference = uint32_t;
+
+        const_iterator(const StandTable *table, uint32_t row) : table_(table), row_(row) {}
+        uint32_t operator*() const { return row_; }
+        const_iterator &operator++()
+        {
+            row_ = table_->next_[row_];
+            return *this;
+        }
+        bool operator==(const const_iterator &other) const { return row_ == other.row_; }
+        bool operator!=(const const_iterator &other) const { return row_ != other.row_; }
+
+    private:
+        const StandTable *table_;
+        uint32_t row_;
+    };
+
+    // Walks live rows in natural name order
+    class sorted_iterator
+    {
+    public:
+        using base = std::map<NaturalKey, uint32_t>::const_iterator;
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = uint32_t;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const uint32_t *;
+        using reference = uint32_t;
+
+        explicit sorted_iterator(base it) : it_(it) {}
+        uint32_t operator*() const { return it_->second; }
+        sorted_iterator &operator++()
+        {
+            ++it_;
+            return *this;
+        }
+        sorted_iterator &operator--()
+        {
+            --it_;
+            return *this;
+        }
+        bool operator==(const sorted_iterator &other) const { return it_ == other.it_; }
+        bool operator!=(const sorted_iterator &other) const { return it_ != other.it_; }
+
+    private:
+        base it_;
+    };
+
+    struct SortedRange
+    {
+        sorted_iterator first;
+        sorted_iterator last;
+        sorted_iterator begin() const { return first; }
+        sorted_iterator end() const { return last; }
+    };
+
+    StandTable();
+
+    const_iterator begin() const { return const_iterator(this, head_); }
+    const_iterator end() const { return const_iterator(this, npos); }
+
+    void clear();
+    void load(const nlohmann::ordered_json &standsJson);
+
+    // Compact native-endian dump of the whole table with its name and order indexes. The
+    // spatial grid is not stored, readSnapshot rebuilds it from the coordinate columns
+    void writeSnapshot(std::string &out) const;
+    // Restores a writeSnapshot dump and advances data past it, leaves the table empty on failure
+    bool readSnapshot(const char *&data, const char *end);
+
+    size_t size() const { return size_; }
+    // Changes with every edit that alters the content, copies keep the value of their source
+    uint64_t revision() const { return revision_; }
+    bool empty() const { return size_ == 0; }
+
+    uint32_t find(const std::string &name) const;
+    bool contains(const std::string &name) const { return find(name) != npos; }
+
+    // Returns the new row, or npos if the name is already taken
+    uint32_t insert(const std::string &name, const StandRecord &record);
+    // Copies every setting of sourceRow without materializing a record
+    uint32_t insertCopy(const std::string &name, uint32_t sourceRow);
+    void erase(uint32_t row);
+    // Keeps the row id and its position in insertion order, fails if newName is taken
+    bool rename(uint32_t row, const std::string &newName);
+
+    StandRecord record(uint32_t row) const;
+    void setRecord(uint32_t row, const StandRecord &record);
+    void setCoordinates(uint32_t row, const Coordinates &coordinates);
+    nlohmann::ordered_json toJson(uint32_t row) const { return record(row).toJson(); }
+
+    // Natural name order, kept up to date on every insert, rename and erase
+    SortedRange sorted() const { return {sorted_iterator(order_.begin()), sorted_iterator(order_.end())}; }
+    // Rows in natural order whose Code holds every bit of codeBits and Use every bit of useBits
+    std::vector<uint32_t> withLetters(uint8_t codeBits, uint8_t useBits) const;
+
+    const std::string &name(uint32_t row) const { return names_[row]; }
+    const NaturalKey &naturalKey(uint32_t row) const { return keys_[row]; }
+    bool hasCoordinates(uint32_t row) const { return flags_[row] & HasCoordinates; }
+    Coordinates coordinates(uint32_t row) const { return {lat_[row], lon_[row], radius_[row], (flags_[row] & HasRadius) != 0}; }
+    double lat(uint32_t row) const { return lat_[row]; }
+    double lon(uint32_t row) const { return lon_[row]; }
+    double radius(uint32_t row) const { return radius_[row]; }
+    // Radius drawn and checked for overlaps, DEFAULT_RADIUS when none is set
+    double standRadius(uint32_t row) const { return flags_[row] & HasRadius ? radius_[row] : DEFAULT_RADIUS; }
+    uint8_t code(uint32_t row) const { return code_[row]; }
+    uint8_t use(uint32_t row) const { return use_[row]; }
+    Schengen schengen(uint32_t row) const { return static_cast<Schengen>(schengen_[row]); }
+    std::optional<int> wingspan(uint32_t row) const;
+    std::optional<int> priority(uint32_t row) const;
+    const Apron *apron(uint32_t row) const { return cold_[row] && cold_[row]->apron ? &*cold_[row]->apron : nullptr; }
+    const nlohmann::ordered_json *extra(uint32_t row) const { return cold_[row] ? &cold_[row]->extra : nullptr; }
+    // The stand as read, only kept while toJson would not give it back (letter order,
+    // empty lists, key order) and dropped by the next edit of the row
+    const nlohmann::ordered_json *source(uint32_t row) const
+    {
+        return cold_[row] && cold_[row]->source ? &*cold_[row]->source : nullptr;
+    }
+    // Loaders pass the stand as read when applyField flagged it, nullopt drops a kept one
+    void setSource(uint32_t row, std::optional<nlohmann::ordered_json> source);
+
+    // Interned lists: callsigns/countries/block hold string ids, remarks hold key/value id pairs
+    uint32_t callsigns(uint32_t row) const { return callsigns_[row]; }
+    uint32_t countries(uint32_t row) const { return countries_[row]; }
+    uint32_t block(uint32_t row) const { return block_[row]; }
+    uint32_t remarks(uint32_t row) const { return remarks_[row]; }
+    const std::vector<uint32_t> &list(uint32_t listId) const { return lists_[listId]; }
+    const std::string &string(uint32_t stringId) const { return strings_[stringId]; }
+
+    // Grid over stand circles, ids are rows; kept in sync with every coordinate change
+    const SpatialIndex &spatial() const { return spatial_; }
+
+private:
+    enum Flags : uint8_t
+    {
+        HasCoordinates = 1,
+        HasRadius = 2,
+        HasWingspan = 4,
+        HasPriority = 8
+    };
+
+    // Rarely present data, shared between copies of a row and replaced on edit
+    struct StandCold
+    {
+        std::optional<Apron> apron;
+        nlohmann::ordered_json extra;
+        std::optional<nlohmann::ordered_json> source;
+    };
+
+    static uint64_t hashName(const std::string &name);
+    size_t findSlot(const std::string &name, uint64_t hash) const;
+    void indexInsert(uint32_t row);
+    void indexErase(uint32_t row);
+    void rehash(size_t capacity);
+    uint32_t allocateRow(const std::string &name);
+    void touch();
+    void assignRecord(uint32_t row, const StandRecord &record);
+
+    uint32_t internString(const std::string &value);
+    uint32_t internList(std::vector<uint32_t> ids);
+    uint32_t internStrings(const std::vector<std::string> &values);
+    std::vector<std::string> listStrings(uint32_t listId) const;
+
+    // Row bookkeeping
+    std::vector<std::string> names_;
+    std::vector<uint64_t> hashes_;
+    std::vector<NaturalKey> keys_;
+    std::vector<uint32_t> prev_;
+    std::vector<uint32_t> next_;
+    std::vector<uint32_t> freeRows_;
+    std::vector<uint32_t> slots_; // row id per slot, npos when empty
+    std::map<NaturalKey, uint32_t> order_;
+    SpatialIndex spatial_;
+    uint32_t head_ = npos;
+    uint32_t tail_ = npos;
+    size_t size_ = 0;
+    uint64_t revision_ = 0;
+
+    // Stand columns
+    std::vector<double> lat_;
+    std::vector<double> lon_;
+    std::vector<double> radius_;
+    std::vector<uint8_t> flags_;
+    std::vector<uint8_t> code_;
+    std::vector<uint8_t> use_;
+    std::vector<int8_t> schengen_;
+    std::vector<int32_t> wingspan_;
+    std::vector<int32_t> priority_;
+    std::vector<uint32_t> callsigns_;
+    std::vector<uint32_t> countries_;
+    std::vector<uint32_t> block_;
+    std::vector<uint32_t> remarks_;
+    std::vector<std::shared_ptr<const StandCold>> cold_;
+
+    // Intern pools, only ever grow during a session
+    std::vector<std::string> strings_;
+    std::unordered_map<std::string, uint32_t> stringIds_;
+    std::vector<std::vector<uint32_t>> lists_;
+    std::map<std::vector<uint32_t>, uint32_t> listIds_;
+};
@@ -1,9 +1,66 @@
 #include "stands.h"
 #include "utils.h"
+#include "overlap_engine.h"
+#include "coordinate_batch.h"
 #include <iostream>
 #include <algorithm>
+#include <iomanip>
 #include <sstream>
 
+// Parses a comma separated "Code":"Remark" list, a repeated code overwrites the earlier remark
+static std::vector<std::pair<std::string, std::string>> parseRemarks(const std::string &input)
+{
+    std::vector<std::pair<std::string, std::string>> remarks;
+    for (const auto &remark : splitRemark(input))
+    {
+        size_t colonPos = remark.find(':');
+        std::string key = remark.substr(0, colonPos);
+        key.erase(std::remove_if(key.begin(), key.end(), ::isspace), key.end());
+        std::transform(key.begin(), key.end(), key.begin(), ::toupper);
+        std::string value = remark.substr(colonPos + 1);
+        auto existing = std::find_if(remarks.begin(), remarks.end(), [&key](const auto &entry)
+                                     { return entry.first == key; });
+        if (existing != remarks.end())
+            existing->second = value;
+        else
+            remarks.emplace_back(key, value);
+    }
+    return remarks;
+}
+
+// Distance with one decimal, e.g. "12.5 m"
+static std::string formatDistance(double meters)
+{
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(1) << meters << " m";
+    return out.str();
+}
+
+// Echoes rejected coordinates with a caret under the first offending character
+static void printCoordinateError(const std::string &text, const CoordinateParse &parse)
+{
+    std::cout << RED << "  " << text << "\n  " << std::string(parse.errorPos, ' ') << "^ " << parse.error << RESET << std::endl;
+}
+
+// Warns when the circle of a freshly placed stand intersects existing stands
+static void warnOverlaps(const StandTable &stands, uint32_t row)
+{
+    if (!stands.hasCoordinates(row))
+        return;
+    auto hits = stands.spatial().overlapping(stands.lat(row), stands.lon(row), stands.standRadius(row), row);
+    hits.erase(std::remove_if(hits.begin(), hits.end(), [&stands, row](const SpatialIndex::Hit &hit)
+                              { return blocksEachOther(stands, row, hit.id); }),
+               hits.end());
+    if (hits.empty())
+        return;
+    std::cout << YELLOW << "Warning: stand " << stands.name(row) << " overlaps";
+    for (size_t i = 0; i < hits.size(); i++)
+    {
+        std::cout << (i ? ", " : " ") << stands.name(hits[i].id) << " (" << formatDistance(hits[i].distance) << " apart)";
+    }
+    std::cout << RESET << std::endl;
+}
+
 void printMenu()
 {
     std::cout << GREY;
@@ -27,77 +84,84 @@ void printMenu()
     std::cout << " priority <standName> : edit existing stand priority only" << std::endl;
     std::cout << " apron <standName> : edit existing stand apron status only" << std::endl;
     std::cout << " list : list all stands" << std::endl;
+    std::cout << " filter code <letters> use <letters> : list the stands accepting every given code and use" << std::endl;
+    std::cout << " nearest <lat:lon> : list the stands closest to a position" << std::endl;
+    std::cout << " within <lat:lon:radius> : list the stands within radius meters of a position" << std::endl;
+    std::cout << " overlaps [export] : list every pair of stands whose circles intersect, export writes <ICAO>_overlaps.csv" << std::endl;
     std::cout << " map : generate HTML map visualization for debugging" << std::endl;
+    std::cout << " map debounce [ms] : show or set how long edits are collected before the map is rewritten" << std::endl;
+    std::cout << " map files [on|off] : show or set whether the map is written to disk, off serves it from memory only" << std::endl;
+    std::cout << " map renderer [auto|svg|canvas] : show or set how the map draws stands, canvas keeps large airports smooth" << std::endl;
     std::cout << " save : save changes and exit" << std::endl;
     std::cout << " config : select another config (will not save current changes)" << std::endl;
     std::cout << " exit : exit without saving" << std::endl;
     std::cout << RESET;
 }
 
-void printStandInfo(const nlohmann::ordered_json &standJson)
+void printStandInfo(const StandRecord &stand)
 {
     std::cout << GREY;
-    if (standJson.contains("Coordinates"))
+    if (stand.hasCoordinates)
     {
-        std::cout << " | Coordinates: " << standJson["Coordinates"] << "|";
+        std::cout << " | Coordinates: " << std::quoted(formatCoordinates(stand.coordinates)) << "|";
     }
-    if (standJson.contains("Code"))
+    if (stand.code)
     {
-        std::cout << " Code: " << standJson["Code"] << "|";
+        std::cout << " Code: " << std::quoted(codeString(stand.code)) << "|";
     }
-    if (standJson.contains("Use"))
+    if (stand.use)
     {
-        std::cout << " Use: " << standJson["Use"] << "|";
+        std::cout << " Use: " << std::quoted(useString(stand.use)) << "|";
     }
-    if (standJson.contains("Schengen"))
+    if (stand.schengen != Schengen::Unset)
     {
-        std::cout << " Schengen: " << (standJson["Schengen"] ? "Yes" : "No") << "|";
+        std::cout << " Schengen: " << (stand.schengen == Schengen::Yes ? "Yes" : "No") << "|";
     }
-    if (standJson.contains("Callsigns"))
+    if (!stand.callsigns.empty())
     {
         std::cout << " Callsigns: ";
-        for (const auto &callsign : standJson["Callsigns"])
+        for (const auto &callsign : stand.callsigns)
         {
-            std::cout << callsign << " ";
+            std::cout << std::quoted(callsign) << " ";
         }
         std::cout << "|";
     }
-    if (standJson.contains("Countries"))
+    if (!stand.countries.empty())
     {
         std::cout << " Countries: ";
-        for (const auto &country : standJson["Countries"])
+        for (const auto &country : stand.countries)
         {
-            std::cout << country << " ";
+            std::cout << std::quoted(country) << " ";
         }
         std::cout << "|";
     }
-    if (standJson.contains("Block"))
+    if (!stand.block.empty())
     {
         std::cout << " Block: ";
-        for (const auto &blocked : standJson["Block"])
+        for (const auto &blocked : stand.block)
         {
-            std::cout << blocked << " ";
+            std::cout << std::quoted(blocked) << " ";
         }
         std::cout << "|";
     }
-    if (standJson.contains("Remark"))
+    if (!stand.remarks.empty())
     {
         std::cout << " Remark: ";
-        for (const auto &[key, value] : standJson["Remark"].items())
+        for (const auto &[key, value] : stand.remarks)
         {
-            std::cout << key << " : " << value << " ";
+            std::cout << key << " : " << std::quoted(value) << " ";
         }
         std::cout << "|";
     }
-    if (standJson.contains("Wingspan"))
+    if (stand.wingspan)
     {
-        std::cout << " Wingspan: " << standJson["Wingspan"] << "m |";
+        std::cout << " Wingspan: " << *stand.wingspan << "m |";
     }
-    if (standJson.contains("Priority"))
+    if (stand.priority)
     {
-        std::cout << " Priority: " << standJson["Priority"] << "|";
+        std::cout << " Priority: " << *stand.priority << "|";
     }
-    if (standJson.contains("Apron"))
+    if (stand.isApron())
     {
         std::cout << " Apron: ";
         std::cout << "Yes";
@@ -106,15 +170,15 @@ void printStandInfo(const nlohmann::ordered_json &standJson)
     std::cout << RESET << std::endl;
 }
 
-void listAllStands(const nlohmann::ordered_json &configJson)
+void listAllStands(const StandTable &stands)
 {
-    if (configJson.contains("Stands") && configJson["Stands"].is_object())
+    if (!stands.empty())
     {
         std::cout << "Current stands:" << std::endl;
-        for (auto &[key, value] : configJson["Stands"].items())
+        for (uint32_t row : stands.sorted())
         {
-            std::cout << " - " << CYAN << key << RESET;
-            printStandInfo(value);
+            std::cout << " - " << CYAN << stands.name(row) << RESET;
+            printStandInfo(stands.record(row));
         }
     }
     else
@@ -123,36 +187,161 @@ void listAllStands(const nlohmann::ordered_json &configJson)
     }
 }
 
-void addStand(nlohmann::ordered_json &configJson, const std::string &standName)
+void filterStands(const StandTable &stands, const std::string &query)
 {
-    std::string standNameUpper = standName;
-    std::transform(standNameUpper.begin(), standNameUpper.end(), standNameUpper.begin(), ::toupper);
-    if (!configJson.contains("Stands") || !configJson["Stands"].is_object())
+    // Pairs of "code <letters>" / "use <letters>", e.g. "code E use C"
+    std::istringstream words(query);
+    std::string field, letters;
+    uint8_t codeBits = 0;
+    uint8_t useBits = 0;
+    bool valid = true;
+    while (valid && words >> field)
+    {
+        std::transform(field.begin(), field.end(), field.begin(), ::tolower);
+        bool gotLetters = static_cast<bool>(words >> letters);
+        std::transform(letters.begin(), letters.end(), letters.begin(), ::toupper);
+        if (gotLetters && field == "code" && codeIsValid(letters))
+            codeBits |= codeMask(letters);
+        else if (gotLetters && field == "use" && useIsValid(letters))
+            useBits |= useMask(letters);
+        else
+            valid = false;
+    }
+    if (!valid || (!codeBits && !useBits))
+    {
+        std::cout << "Invalid filter. Please use code <A-F letters> and/or use <A, C, H, M, P letters> (e.g., code E use C)." << std::endl;
+        return;
+    }
+
+    auto rows = stands.withLetters(codeBits, useBits);
+    if (rows.empty())
+    {
+        std::cout << "No stands match." << std::endl;
+        return;
+    }
+    std::cout << rows.size() << " matching stands:" << std::endl;
+    for (uint32_t row : rows)
+    {
+        std::cout << " - " << CYAN << stands.name(row) << RESET << GREY << " Code: " << codeString(stands.code(row))
+                  << " Use: " << useString(stands.use(row)) << RESET << std::endl;
+    }
+}
+
+void nearestStands(const StandTable &stands, const std::string &position)
+{
+    CoordinateParse parse = parseCoordinateText(position, false);
+    if (!parse.ok)
+    {
+        std::cout << "Invalid position. Please use lat:lon (e.g., 43.666359:7.216941)." << std::endl;
+        printCoordinateError(position, parse);
+        return;
+    }
+    const Coordinates &point = parse.coordinates;
+    auto hits = stands.spatial().nearest(point.lat, point.lon, 5);
+    if (hits.empty())
+    {
+        std::cout << "No stands with coordinates." << std::endl;
+        return;
+    }
+    std::cout << "Nearest stands:" << std::endl;
+    for (const auto &hit : hits)
+    {
+        std::cout << " - " << CYAN << stands.name(hit.id) << RESET << GREY << " " << formatDistance(hit.distance) << RESET << std::endl;
+    }
+}
+
+void standsWithin(const StandTable &stands, const std::string &area)
+{
+    CoordinateParse parse = parseCoordinateText(area);
+    if (!parse.ok || !parse.coordinates.hasRadius)
+    {
+        std::cout << "Invalid area. Please use lat:lon:radius (e.g., 43.666359:7.216941:200)." << std::endl;
+        if (!parse.ok)
+            printCoordinateError(area, parse);
+        return;
+    }
+    const Coordinates &circle = parse.coordinates;
+    auto hits = stands.spatial().within(circle.lat, circle.lon, circle.radius);
+    if (hits.empty())
+    {
+        std::cout << "No stands within " << formatDistance(circle.radius) << "." << std::endl;
+        return;
+    }
+    std::cout << hits.size() << " stands within " << formatDistance(circle.radius) << ":" << std::endl;
+    for (const auto &hit : hits)
+    {
+        std::cout << " - " << CYAN << stands.name(hit.id) << RESET << GREY << " " << formatDistance(hit.distance) << RESET << std::endl;
+    }
+}
+
+void listOverlaps(const StandTable &stands, const std::string &icao, bool exportList)
+{
+    auto conflicts = findOverlaps(stands);
+    // Report each pair with its naturally smaller stand first, pairs in natural order
+    for (auto &conflict : conflicts)
     {
-        configJson["Stands"] = nlohmann::ordered_json::object();
+        if (stands.naturalKey(conflict.b) < stands.naturalKey(conflict.a))
+            std::swap(conflict.a, conflict.b);
     }
-    if (configJson["Stands"].contains(standNameUpper))
+    std::sort(conflicts.begin(), conflicts.end(), [&stands](const StandConflict &x, const StandConflict &y)
+              {
+        if (stands.naturalKey(x.a) != stands.naturalKey(y.a))
+            return stands.naturalKey(x.a) < stands.naturalKey(y.a);
+        return stands.naturalKey(x.b) < stands.naturalKey(y.b); });
+
+    if (conflicts.empty())
+    {
+        std::cout << GREEN << "No overlapping stands." << RESET << std::endl;
+    }
+    else
+    {
+        std::cout << YELLOW << conflicts.size() << " overlapping stand pairs (pairs blocking each other are skipped):" << RESET << std::endl;
+        for (const auto &conflict : conflicts)
+        {
+            std::cout << " - " << CYAN << stands.name(conflict.a) << RESET << " / " << CYAN << stands.name(conflict.b) << RESET << GREY
+                      << " " << formatDistance(conflict.distance) << " apart, " << formatDistance(conflict.overlap) << " overlap" << RESET << std::endl;
+        }
+    }
+
+    if (exportList)
+    {
+        std::string path = getBaseDir() + icao + "_overlaps.csv";
+        if (exportOverlaps(stands, conflicts, path))
+            std::cout << GREEN << "Conflict list exported: " << icao << "_overlaps.csv" << RESET << std::endl;
+        else
+            std::cout << RED << "Error writing " << icao << "_overlaps.csv" << RESET << std::endl;
+    }
+}
+
+void addStand(StandTable &stands, const std::string &standName)
+{
+    std::string standNameUpper = standName;
+    std::transform(standNameUpper.begin(), standNameUpper.end(), standNameUpper.begin(), ::toupper);
+    if (stands.contains(standNameUpper))
     {
         std::cout << "Stand " << standNameUpper << " already exists." << std::endl;
     }
     else
     {
-        configJson["Stands"][standNameUpper] = nlohmann::ordered_json::object();
+        StandRecord stand;
 
         std::cout << "Enter coordinates (format: lat:lon:radius): ";
         std::string coordinates;
         while (true)
         {
             std::getline(std::cin, coordinates);
-            if (!isCoordinatesValid(coordinates))
+            CoordinateParse parse = parseCoordinateText(coordinates);
+            if (!parse.ok)
             {
                 std::cout << RED << "Invalid coordinates format. Please use lat:lon:radius (e.g., 43.666359:7.216941:20)." << RESET << std::endl;
+                printCoordinateError(coordinates, parse);
                 std::cout << "Enter coordinates (format: lat:lon:radius): ";
                 continue;
             }
             else
             {
-                configJson["Stands"][standNameUpper]["Coordinates"] = coordinates;
+                stand.hasCoordinates = true;
+                stand.coordinates = parse.coordinates;
                 break;
             }
         }
@@ -170,7 +359,7 @@ void addStand(nlohmann::ordered_json &configJson, const std::string &standName)
                     continue;
                 }
                 std::transform(code.begin(), code.end(), code.begin(), ::toupper);
-                configJson["Stands"][standNameUpper]["Code"] = code;
+                stand.code = codeMask(code);
             }
             break;
         }
@@ -188,7 +377,7 @@ void addStand(nlohmann::ordered_json &configJson, const std::string &standName)
                     continue;
                 }
                 std::transform(use.begin(), use.end(), use.begin(), ::toupper);
-                configJson["Stands"][standNameUpper]["Use"] = use;
+                stand.use = useMask(use);
             }
             break;
         }
@@ -199,7 +388,7 @@ void addStand(nlohmann::ordered_json &configJson, const std::string &standName)
         bool notSchengen = (schengenInput == "n" || schengenInput == "N");
         if (schengen || notSchengen)
         {
-            configJson["Stands"][standNameUpper]["Schengen"] = schengen;
+            stand.schengen = schengen ? Schengen::Yes : Schengen::No;
         }
 
         std::cout << "Enter callsigns (comma separated, optional): ";
@@ -210,7 +399,7 @@ void addStand(nlohmann::ordered_json &configJson, const std::string &standName)
             std::vector<std::string> callsigns = splitString(callsignsInput);
             if (!callsigns.empty())
             {
-                configJson["Stands"][standNameUpper]["Callsigns"] = callsigns;
+                stand.callsigns = callsigns;
             }
         }
 
@@ -222,7 +411,7 @@ void addStand(nlohmann::ordered_json &configJson, const std::string &standName)
             std::vector<std::string> countries = splitString(countriesInput);
             if (!countries.empty())
             {
-                configJson["Stands"][standNameUpper]["Countries"] = countries;
+                stand.countries = countries;
             }
         }
 
@@ -234,7 +423,7 @@ void addStand(nlohmann::ordered_json &configJson, const std::string &standName)
             std::vector<std::string> blocked = splitString(blockInput);
             if (!blocked.empty())
             {
-                configJson["Stands"][standNameUpper]["Block"] = blocked;
+                stand.block = blocked;
             }
         }
 
@@ -243,19 +432,7 @@ void addStand(nlohmann::ordered_json &configJson, const std::string &standName)
         std::getline(std::cin, remarkInput);
         if (!remarkInput.empty())
         {
-            std::vector<std::string> remarks = splitRemark(remarkInput);
-            if (!remarks.empty())
-            {
-                for (const auto &remark : remarks)
-                {
-                    size_t colonPos = remark.find(':');
-                    std::string key = remark.substr(0, colonPos);
-                    key.erase(std::remove_if(key.begin(), key.end(), ::isspace), key.end());
-                    std::transform(key.begin(), key.end(), key.begin(), ::toupper);
-                    std::string value = remark.substr(colonPos + 1);
-                    configJson["Stands"][standNameUpper]["Remark"][key] = value;
-                }
-            }
+            stand.remarks = parseRemarks(remarkInput);
         }
 
         std::cout << "Enter max Wingspan (integer, optional): ";
@@ -268,7 +445,7 @@ void addStand(nlohmann::ordered_json &configJson, const std::string &standName)
                 try
                 {
                     int wingspan = std::stoi(wingspanInput);
-                    configJson["Stands"][standNameUpper]["Wingspan"] = wingspan;
+                    stand.wingspan = wingspan;
                     break;
                 }
                 catch (const std::exception &e)
@@ -292,7 +469,7 @@ void addStand(nlohmann::ordered_json &configJson, const std::string &standName)
                 try
                 {
                     int priority = std::stoi(priorityInput);
-                    configJson["Stands"][standNameUpper]["Priority"] = priority;
+                    stand.priority = priority;
                     break;
                 }
                 catch (const std::exception &e)
@@ -329,7 +506,10 @@ void addStand(nlohmann::ordered_json &configJson, const std::string &standName)
                 }
                 else
                 {
-                    configJson["Stands"][standNameUpper]["Apron"]["Size"] = std::stoi(size);
+                    if (!stand.apron)
+                        stand.apron.emplace();
+                    stand.apron->size = std::stoi(size);
+                    stand.extra.erase("Apron");
                     break;
                 }
             }
@@ -357,25 +537,28 @@ void addStand(nlohmann::ordered_json &configJson, const std::string &standName)
                 }
             }
             if (!coordinatesList.empty()) {
-                configJson["Stands"][standNameUpper]["Apron"]["Coordinates"] = coordinatesList;
+                stand.apron->coordinates = coordinatesList;
             }
         }
 
+        uint32_t row = stands.insert(standNameUpper, stand);
         std::cout << "Stand " << standNameUpper << " added." << std::endl;
-        printStandInfo(configJson["Stands"][standNameUpper]);
+        printStandInfo(stand);
         std::cout << std::endl;
+        warnOverlaps(stands, row);
     }
 }
 
-void removeStand(nlohmann::ordered_json &configJson, const std::string &standName)
+void removeStand(StandTable &stands, const std::string &standName)
 {
     std::string standNameUpper = standName;
     std::transform(standNameUpper.begin(), standNameUpper.end(), standNameUpper.begin(), ::toupper);
-    if (configJson.contains("Stands") && configJson["Stands"].is_object())
+    if (!stands.empty())
     {
-        if (configJson["Stands"].contains(standNameUpper))
+        uint32_t row = stands.find(standNameUpper);
+        if (row != StandTable::npos)
         {
-            configJson["Stands"].erase(standNameUpper);
+            stands.erase(row);
             std::cout << RED << "Stand " << standNameUpper << " removed." << RESET << std::endl;
         }
         else
@@ -389,20 +572,22 @@ void removeStand(nlohmann::ordered_json &configJson, const std::string &standNam
     }
 }
 
-void editStand(nlohmann::ordered_json &configJson, const std::string &standName)
+void editStand(StandTable &stands, const std::string &standName)
 {
     std::string standNameUpper = standName;
     std::transform(standNameUpper.begin(), standNameUpper.end(), standNameUpper.begin(), ::toupper);
-    if (configJson.contains("Stands") && configJson["Stands"].is_object() && configJson["Stands"].contains(standNameUpper))
+    uint32_t row = stands.find(standNameUpper);
+    if (row != StandTable::npos)
     {
-        nlohmann::ordered_json &standJson = configJson["Stands"][standNameUpper];
+        StandRecord stand = stands.record(row);
         std::cout << "Editing stand " << standNameUpper << std::endl;
-        printStandInfo(standJson);
+        printStandInfo(stand);
 
-        iterateAndModifyStandSettings(standJson, standNameUpper);
+        iterateAndModifyStandSettings(stand, standNameUpper);
 
+        stands.setRecord(row, stand);
         std::cout << "Stand " << standNameUpper << " updated." << std::endl;
-        printStandInfo(standJson);
+        printStandInfo(stand);
         std::cout << std::endl;
     }
     else
@@ -411,20 +596,18 @@ void editStand(nlohmann::ordered_json &configJson, const std::string &standName)
     }
 }
 
-void editStandRadius(nlohmann::ordered_json &configJson, const std::string &standName)
+void editStandRadius(StandTable &stands, const std::string &standName)
 {
     std::string standNameUpper = standName;
     std::transform(standNameUpper.begin(), standNameUpper.end(), standNameUpper.begin(), ::toupper);
-    if (configJson.contains("Stands") && configJson["Stands"].is_object() && configJson["Stands"].contains(standNameUpper))
+    uint32_t row = stands.find(standNameUpper);
+    if (row != StandTable::npos)
     {
-        nlohmann::ordered_json &standJson = configJson["Stands"][standNameUpper];
+        StandRecord stand = stands.record(row);
         std::cout << "Editing radius for stand " << standNameUpper << std::endl;
-        printStandInfo(standJson);
+        printStandInfo(stand);
 
-        std::string coordinatesStr = standJson["Coordinates"].get<std::string>();
-        size_t lastColon = coordinatesStr.find_last_of(':');
-        std::string coordinates = coordinatesStr.substr(0, lastColon);
-        std::string radius = (lastColon != std::string::npos) ? coordinatesStr.substr(lastColon + 1) : "";
+        std::string radius = stand.coordinates.hasRadius ? formatNumber(stand.coordinates.radius) : "";
 
         std::cout << "Enter new radius (current: " << radius << ") : ";
         std::string radiusInput;
@@ -440,12 +623,14 @@ void editStandRadius(nlohmann::ordered_json &configJson, const std::string &stan
             }
             else
             {
-                standJson["Coordinates"] = coordinates + ":" + radiusInput;
+                stand.coordinates.radius = std::stod(radiusInput);
+                stand.coordinates.hasRadius = true;
                 break;
             }
         }
+        stands.setRecord(row, stand);
         std::cout << "Stand " << standNameUpper << " radius updated." << std::endl;
-        printStandInfo(standJson);
+        printStandInfo(stand);
         std::cout << std::endl;
     }
     else
@@ -454,12 +639,14 @@ void editStandRadius(nlohmann::ordered_json &configJson, const std::string &stan
     }
 }
 
-void copyStand(nlohmann::ordered_json &configJson, const std::string &standName)
+void copyStand(StandTable &stands, const std::string &standName)
 {
     std::string standNameUpper = standName;
     std::transform(standNameUpper.begin(), standNameUpper.end(), standNameUpper.begin(), ::toupper);
-    if (configJson.contains("Stands") && configJson["Stands"].is_object() && configJson["Stands"].contains(standNameUpper))
+    uint32_t sourceRow = stands.find(standNameUpper);
+    if (sourceRow != StandTable::npos)
     {
+        uint32_t row = StandTable::npos;
         std::string newStandName;
         std::cout << "Enter new stand name for the copy: ";
         while (true)
@@ -472,7 +659,7 @@ void copyStand(nlohmann::ordered_json &configJson, const std::string &standName)
                 std::cout << "Enter new stand name for the copy: ";
                 continue;
             }
-            else if (configJson["Stands"].contains(newStandName))
+            else if (stands.contains(newStandName))
             {
                 std::cout << "Stand " << newStandName << " already exists." << std::endl;
                 std::cout << "Enter new stand name for the copy: ";
@@ -480,7 +667,7 @@ void copyStand(nlohmann::ordered_json &configJson, const std::string &standName)
             }
             else
             {
-                configJson["Stands"][newStandName] = configJson["Stands"][standNameUpper];
+                row = stands.insertCopy(newStandName, sourceRow);
                 break;
             }
         }
@@ -489,21 +676,24 @@ void copyStand(nlohmann::ordered_json &configJson, const std::string &standName)
         while (true)
         {
             std::getline(std::cin, coordinates);
-            if (!isCoordinatesValid(coordinates))
+            CoordinateParse parse = parseCoordinateText(coordinates);
+            if (!parse.ok)
             {
                 std::cout << "Invalid coordinates format. Please use lat:lon:radius (e.g., 43.666359:7.216941:20)." << std::endl;
+                printCoordinateError(coordinates, parse);
                 std::cout << "Enter new coordinates for the copied stand (format: lat:lon:radius): ";
                 continue;
             }
             else
             {
-                configJson["Stands"][newStandName]["Coordinates"] = coordinates;
+                stands.setCoordinates(row, parse.coordinates);
                 break;
             }
         }
         std::cout << "Stand " << standNameUpper << " copied to " << newStandName << "." << std::endl;
-        printStandInfo(configJson["Stands"][newStandName]);
+        printStandInfo(stands.record(row));
         std::cout << std::endl;
+        warnOverlaps(stands, row);
     }
     else
     {
@@ -511,28 +701,29 @@ void copyStand(nlohmann::ordered_json &configJson, const std::string &standName)
     }
 }
 
-void batchcopy(nlohmann::ordered_json &configJson, const std::string &standName)
+void batchcopy(StandTable &stands, const std::string &standName)
 {
     std::string standNameUpper = standName;
     std::transform(standNameUpper.begin(), standNameUpper.end(), standNameUpper.begin(), ::toupper);
 
-    if (!configJson.contains("Stands") || !configJson["Stands"].is_object() || !configJson["Stands"].contains(standNameUpper))
+    uint32_t sourceRow = stands.find(standNameUpper);
+    if (sourceRow == StandTable::npos)
     {
         std::cout << "Stand " << standNameUpper << " does not exist." << std::endl;
         return;
     }
 
     std::cout << "Batch copying from stand: " << standNameUpper << std::endl;
-    printStandInfo(configJson["Stands"][standNameUpper]);
+    printStandInfo(stands.record(sourceRow));
     std::cout << std::endl;
 
     std::cout << "Enter new stand entries (format: name:lat:lon:radius)" << std::endl;
     std::cout << "Example: A1:43.666359:7.216941:20" << std::endl;
     std::cout << "Press Enter on empty line to finish:" << std::endl;
 
-    int copiedCount = 0;
+    // Pasted blocks are collected first and parsed in one pass
+    std::string block;
     std::string line;
-
     while (true)
     {
         std::cout << "> ";
@@ -542,52 +733,37 @@ void batchcopy(nlohmann::ordered_json &configJson, const std::string &standName)
         {
             break; // Exit on empty line
         }
+        block += line;
+        block += '\n';
+    }
 
-        // Parse the line format: name:lat:lon:radius
-        std::vector<std::string> parts;
-        std::istringstream stream(line);
-        std::string part;
-
-        while (std::getline(stream, part, ':'))
-        {
-            parts.push_back(part);
-        }
+    CoordinateBatch batch = parseCoordinateBatch(block);
+    int copiedCount = 0;
+    for (size_t i = 0; i < batch.size(); i++)
+    {
+        std::string newStandName(batch.names[i]);
+        std::transform(newStandName.begin(), newStandName.end(), newStandName.begin(), ::toupper);
 
-        if (parts.size() != 4)
+        if (batch.errors[i] != BatchError::None)
         {
-            std::cout << "Invalid format. Expected: name:lat:lon:radius" << std::endl;
+            std::cout << "Line " << batch.lines[i] << " (" << newStandName << "): " << batchErrorText(batch.errors[i]) << ". Skipping." << std::endl;
             continue;
         }
 
-        std::string newStandName = parts[0];
-        std::string coordinates = parts[1] + ":" + parts[2] + ":" + parts[3];
-
-        // Convert stand name to uppercase
-        std::transform(newStandName.begin(), newStandName.end(), newStandName.begin(), ::toupper);
-
         // Check if stand already exists
-        if (configJson["Stands"].contains(newStandName))
+        if (stands.contains(newStandName))
         {
             std::cout << "Stand " << newStandName << " already exists. Skipping." << std::endl;
             continue;
         }
 
-        // Validate coordinates
-        std::string coordsCopy = coordinates; // Make a copy since isCoordinatesValid modifies it
-        if (!isCoordinatesValid(coordsCopy))
-        {
-            std::cout << "Invalid coordinates format for " << newStandName << ": " << coordinates << std::endl;
-            std::cout << "Expected format: lat:lon:radius (e.g., 43.666359:7.216941:20)" << std::endl;
-            continue;
-        }
-
-        // Copy stand settings from source
-        configJson["Stands"][newStandName] = configJson["Stands"][standNameUpper];
-
-        // Update with new coordinates
-        configJson["Stands"][newStandName]["Coordinates"] = coordsCopy;
+        // Copy stand settings from source, then place it
+        Coordinates position{batch.lat[i], batch.lon[i], batch.radius[i], batch.hasRadius[i] != 0};
+        uint32_t row = stands.insertCopy(newStandName, sourceRow);
+        stands.setCoordinates(row, position);
 
-        std::cout << "Created " << newStandName << " at " << coordsCopy << std::endl;
+        std::cout << "Created " << newStandName << " at " << formatCoordinates(position) << std::endl;
+        warnOverlaps(stands, row);
         copiedCount++;
     }
 
@@ -602,12 +778,14 @@ void batchcopy(nlohmann::ordered_json &configJson, const std::string &standName)
     }
 }
 
-void softStandCopy(nlohmann::ordered_json &configJson, const std::string &standName)
+void softStandCopy(StandTable &stands, const std::string &standName)
 {
     std::string standNameUpper = standName;
     std::transform(standNameUpper.begin(), standNameUpper.end(), standNameUpper.begin(), ::toupper);
-    if (configJson.contains("Stands") && configJson["Stands"].is_object() && configJson["Stands"].contains(standNameUpper))
+    uint32_t sourceRow = stands.find(standNameUpper);
+    if (sourceRow != StandTable::npos)
     {
+        uint32_t row = StandTable::npos;
         std::string newStandName;
         std::cout << "Enter new stand name for the copy: ";
         while (true)
@@ -620,7 +798,7 @@ void softStandCopy(nlohmann::ordered_json &configJson, const std::string &standN
                 std::cout << "Enter new stand name for the copy: ";
                 continue;
             }
-            else if (configJson["Stands"].contains(newStandName))
+            else if (stands.contains(newStandName))
             {
                 std::cout << "Stand " << newStandName << " already exists." << std::endl;
                 std::cout << "Enter new stand name for the copy: ";
@@ -628,15 +806,17 @@ void softStandCopy(nlohmann::ordered_json &configJson, const std::string &standN
             }
             else
             {
-                configJson["Stands"][newStandName] = configJson["Stands"][standNameUpper];
+                row = stands.insertCopy(newStandName, sourceRow);
                 break;
             }
         }
 
-        iterateAndModifyStandSettings(configJson["Stands"][newStandName], newStandName);
+        StandRecord stand = stands.record(row);
+        iterateAndModifyStandSettings(stand, newStandName);
+        stands.setRecord(row, stand);
 
         std::cout << "Stand " << newStandName << " added." << std::endl;
-        printStandInfo(configJson["Stands"][newStandName]);
+        printStandInfo(stands.record(row));
         std::cout << std::endl;
     }
     else
@@ -645,7 +825,7 @@ void softStandCopy(nlohmann::ordered_json &configJson, const std::string &standN
     }
 }
 
-void iterateAndModifyStandSettings(nlohmann::ordered_json &configJson, const std::string &newStandName)
+void iterateAndModifyStandSettings(StandRecord &stand, const std::string &newStandName)
 {
     std::cout << "Enter new coordinates (format: lat:lon:radius), empty to keep: ";
     std::string coordinates;
@@ -656,20 +836,20 @@ void iterateAndModifyStandSettings(nlohmann::ordered_json &configJson, const std
         {
             break; // Keep current
         }
-        else if (!isCoordinatesValid(coordinates))
+        CoordinateParse parse = parseCoordinateText(coordinates);
+        if (!parse.ok)
         {
             std::cout << RED << "Invalid coordinates format. Please use lat:lon:radius (e.g., 43.666359:7.216941:20)." << RESET << std::endl;
+            printCoordinateError(coordinates, parse);
             std::cout << "Enter new coordinates (format: lat:lon:radius): ";
             continue;
         }
-        else
-        {
-            configJson["Coordinates"] = coordinates;
-            break;
-        }
+        stand.hasCoordinates = true;
+        stand.coordinates = parse.coordinates;
+        break;
     }
 
-    std::cout << "Enter new code (current: " << (configJson.contains("Code") ? configJson["Code"].get<std::string>() : "none") << ", empty to keep, r to remove): ";
+    std::cout << "Enter new code (current: " << (stand.code ? codeString(stand.code) : "none") << ", empty to keep, r to remove): ";
     std::string code;
     while (true)
     {
@@ -680,7 +860,7 @@ void iterateAndModifyStandSettings(nlohmann::ordered_json &configJson, const std
         }
         else if (code == "r" || code == "R")
         {
-            configJson.erase("Code");
+            stand.code = 0;
             break;
         }
         else
@@ -692,12 +872,12 @@ void iterateAndModifyStandSettings(nlohmann::ordered_json &configJson, const std
                 std::cout << "Enter new code (empty to keep, r to remove): ";
                 continue;
             }
-            configJson["Code"] = code;
+            stand.code = codeMask(code);
             break;
         }
     }
 
-    std::cout << "Enter new use (current: " << (configJson.contains("Use") ? configJson["Use"].get<std::string>() : "none") << ", single character, empty to keep, r to remove): ";
+    std::cout << "Enter new use (current: " << (stand.use ? useString(stand.use) : "none") << ", single character, empty to keep, r to remove): ";
     std::string use;
     while (true)
     {
@@ -708,7 +888,7 @@ void iterateAndModifyStandSettings(nlohmann::ordered_json &configJson, const std
         }
         else if (use == "r" || use == "R")
         {
-            configJson.erase("Use");
+            stand.use = 0;
             break;
         }
         else
@@ -720,12 +900,12 @@ void iterateAndModifyStandSettings(nlohmann::ordered_json &configJson, const std
                 continue;
             }
             std::transform(use.begin(), use.end(), use.begin(), ::toupper);
-            configJson["Use"] = use;
+            stand.use = useMask(use);
             break;
         }
     }
 
-    std::cout << "Is it a Schengen stand? (current: " << (configJson.contains("Schengen") ? (configJson["Schengen"].get<bool>() ? "Yes" : "No") : "none") << " Y/N, empty to keep, r to remove): ";
+    std::cout << "Is it a Schengen stand? (current: " << (stand.schengen != Schengen::Unset ? (stand.schengen == Schengen::Yes ? "Yes" : "No") : "none") << " Y/N, empty to keep, r to remove): ";
     std::string schengen;
     while (true)
     {
@@ -736,17 +916,17 @@ void iterateAndModifyStandSettings(nlohmann::ordered_json &configJson, const std
         }
         else if (schengen == "r" || schengen == "R")
         {
-            configJson.erase("Schengen");
+            stand.schengen = Schengen::Unset;
             break;
         }
         else if (schengen == "Y" || schengen == "y")
         {
-            configJson["Schengen"] = true;
+            stand.schengen = Schengen::Yes;
             break;
         }
         else if (schengen == "N" || schengen == "n")
         {
-            configJson["Schengen"] = false;
+            stand.schengen = Schengen::No;
             break;
         }
         else
@@ -756,11 +936,11 @@ void iterateAndModifyStandSettings(nlohmann::ordered_json &configJson, const std
     }
 
     std::cout << "Enter new callsigns (current: ";
-    if (configJson.contains("Callsigns"))
+    if (!stand.callsigns.empty())
     {
-        for (const auto &cs : configJson["Callsigns"])
+        for (const auto &cs : stand.callsigns)
         {
-            std::cout << cs << " ";
+            std::cout << std::quoted(cs) << " ";
         }
     }
     else
@@ -778,7 +958,7 @@ void iterateAndModifyStandSettings(nlohmann::ordered_json &configJson, const std
         }
         else if (callsignsInput == "r" || callsignsInput == "R")
         {
-            configJson.erase("Callsigns");
+            stand.callsigns.clear();
             break;
         }
         else
@@ -786,22 +966,22 @@ void iterateAndModifyStandSettings(nlohmann::ordered_json &configJson, const std
             std::vector<std::string> callsigns = splitString(callsignsInput);
             if (!callsigns.empty())
             {
-                configJson["Callsigns"] = callsigns;
+                stand.callsigns = callsigns;
             }
             else
             {
-                configJson.erase("Callsigns");
+                stand.callsigns.clear();
             }
             break;
         }
     }
 
     std::cout << "Enter new countries (current: ";
-    if (configJson.contains("Countries"))
+    if (!stand.countries.empty())
     {
-        for (const auto &country : configJson["Countries"])
+        for (const auto &country : stand.countries)
         {
-            std::cout << country << " ";
+            std::cout << std::quoted(country) << " ";
         }
     }
     else
@@ -820,7 +1000,7 @@ void iterateAndModifyStandSettings(nlohmann::ordered_json &configJson, const std
         }
         else if (countriesInput == "r" || countriesInput == "R")
         {
-            configJson.erase("Countries");
+            stand.countries.clear();
             break;
         }
         else
@@ -828,22 +1008,22 @@ void iterateAndModifyStandSettings(nlohmann::ordered_json &configJson, const std
             std::vector<std::string> countries = splitString(countriesInput);
             if (!countries.empty())
             {
-                configJson["Countries"] = countries;
+                stand.countries = countries;
             }
             else
             {
-                configJson.erase("Countries");
+                stand.countries.clear();
             }
             break;
         }
     }
 
     std::cout << "Enter new blocked stands (current: ";
-    if (configJson.contains("Block"))
+    if (!stand.block.empty())
     {
-        for (const auto &blk : configJson["Block"])
+        for (const auto &blk : stand.block)
         {
-            std::cout << blk << " ";
+            std::cout << std::quoted(blk) << " ";
         }
     }
     else
@@ -861,7 +1041,7 @@ void iterateAndModifyStandSettings(nlohmann::ordered_json &configJson, const std
         }
         else if (blockInput == "r" || blockInput == "R")
         {
-            configJson.erase("Block");
+            stand.block.clear();
             break;
         }
         else
@@ -869,22 +1049,22 @@ void iterateAndModifyStandSettings(nlohmann::ordered_json &configJson, const std
             std::vector<std::string> blocked = splitString(blockInput);
             if (!blocked.empty())
             {
-                configJson["Block"] = blocked;
+                stand.block = blocked;
             }
             else
             {
-                configJson.erase("Block");
+                stand.block.clear();
             }
             break;
         }
     }
 
     std::cout << "Enter new Remark (current: ";
-    if (configJson.contains("Remark"))
+    if (!stand.remarks.empty())
     {
-        for (const auto &[key, value] : configJson["Remark"].items())
+        for (const auto &[key, value] : stand.remarks)
         {
-            std::cout << key << " : " << value << " ";
+            std::cout << key << " : " << std::quoted(value) << " ";
         }
     }
     else
@@ -902,35 +1082,17 @@ void iterateAndModifyStandSettings(nlohmann::ordered_json &configJson, const std
         }
         else if (remarkInput == "r" || remarkInput == "R")
         {
-            configJson.erase("Remark");
+            stand.remarks.clear();
             break;
         }
         else
         {
-            std::vector<std::string> remarks = splitRemark(remarkInput);
-            if (!remarks.empty())
-            {
-                nlohmann::ordered_json newRemarks;
-                for (const auto &remark : remarks)
-                {
-                    size_t colonPos = remark.find(':');
-                    std::string key = remark.substr(0, colonPos);
-                    key.erase(std::remove_if(key.begin(), key.end(), ::isspace), key.end());
-                    std::transform(key.begin(), key.end(), key.begin(), ::toupper);
-                    std::string value = remark.substr(colonPos + 1);
-                    newRemarks[key] = value;
-                }
-                configJson["Remark"] = newRemarks;
-            }
-            else
-            {
-                configJson.erase("Remark");
-            }
+            stand.remarks = parseRemarks(remarkInput);
             break;
         }
     }
 
-    std::cout << "Enter new max Wingspan (current: " << (configJson.contains("Wingspan") ? std::to_string(configJson["Wingspan"].get<int>()) : "none") << ", integer, empty to keep, r to remove): ";
+    std::cout << "Enter new max Wingspan (current: " << (stand.wingspan ? std::to_string(*stand.wingspan) : "none") << ", integer, empty to keep, r to remove): ";
     std::string wingspanInput;
     while (true)
     {
@@ -941,7 +1103,7 @@ void iterateAndModifyStandSettings(nlohmann::ordered_json &configJson, const std
         }
         else if (wingspanInput == "r" || wingspanInput == "R")
         {
-            configJson.erase("Wingspan");
+            stand.wingspan.reset();
             break;
         }
         else
@@ -949,7 +1111,7 @@ void iterateAndModifyStandSettings(nlohmann::ordered_json &configJson, const std
             try
             {
                 int wingspan = std::stoi(wingspanInput);
-                configJson["Wingspan"] = wingspan;
+                stand.wingspan = wingspan;
                 break;
             }
             catch (const std::exception &e)
@@ -961,7 +1123,7 @@ void iterateAndModifyStandSettings(nlohmann::ordered_json &configJson, const std
         }
     }
 
-    std::cout << "Enter new priority (current: " << (configJson.contains("Priority") ? std::to_string(configJson["Priority"].get<int>()) : "none") << ", integer, empty to keep, r to remove): ";
+    std::cout << "Enter new priority (current: " << (stand.priority ? std::to_string(*stand.priority) : "none") << ", integer, empty to keep, r to remove): ";
     std::string priorityInput;
     while (true)
     {
@@ -972,7 +1134,7 @@ void iterateAndModifyStandSettings(nlohmann::ordered_json &configJson, const std
         }
         else if (priorityInput == "r" || priorityInput == "R")
         {
-            configJson.erase("Priority");
+            stand.priority.reset();
             break;
         }
         else
@@ -980,7 +1142,7 @@ void iterateAndModifyStandSettings(nlohmann::ordered_json &configJson, const std
             try
             {
                 int priority = std::stoi(priorityInput);
-                configJson["Priority"] = priority;
+                stand.priority = priority;
                 break;
             }
             catch (const std::exception &e)
@@ -992,7 +1154,7 @@ void iterateAndModifyStandSettings(nlohmann::ordered_json &configJson, const std
         }
     }
 
-    std::cout << "Is it an apron stand? (current: " << (configJson.contains("Apron") ? "Yes" : "No") << " Y if apron, empty to keep, r to remove): ";
+    std::cout << "Is it an apron stand? (current: " << (stand.isApron() ? "Yes" : "No") << " Y if apron, empty to keep, r to remove): ";
     std::string apronInput;
     while (true)
     {
@@ -1003,7 +1165,8 @@ void iterateAndModifyStandSettings(nlohmann::ordered_json &configJson, const std
         }
         else if (apronInput == "r" || apronInput == "R")
         {
-            configJson.erase("Apron");
+            stand.apron.reset();
+            stand.extra.erase("Apron");
             break;
         }
         else if (apronInput == "Y" || apronInput == "y")
@@ -1025,7 +1188,10 @@ void iterateAndModifyStandSettings(nlohmann::ordered_json &configJson, const std
                 }
                 else
                 {
-                    configJson["Apron"]["Size"] = std::stoi(size);
+                    if (!stand.apron)
+                        stand.apron.emplace();
+                    stand.apron->size = std::stoi(size);
+                    stand.extra.erase("Apron");
                     break;
                 }
             }
@@ -1053,7 +1219,7 @@ void iterateAndModifyStandSettings(nlohmann::ordered_json &configJson, const std
                 }
             }
             if (!coordinatesList.empty()) {
-                configJson["Apron"]["Coordinates"] = coordinatesList;
+                stand.apron->coordinates = coordinatesList;
             }
             break;
         }
@@ -1064,15 +1230,17 @@ void iterateAndModifyStandSettings(nlohmann::ordered_json &configJson, const std
     }
 }
 
-void renameStand(nlohmann::ordered_json &configJson, const std::string &standName)
+void renameStand(StandTable &stands, const std::string &standName)
 {
     std::string oldStandNameUpper = standName;
     std::transform(oldStandNameUpper.begin(), oldStandNameUpper.end(), oldStandNameUpper.begin(), ::toupper);
-    if (configJson.contains("Stands") && configJson["Stands"].is_object())
+    if (!stands.empty())
     {
-        if (!configJson["Stands"].contains(oldStandNameUpper))
+        uint32_t row = stands.find(oldStandNameUpper);
+        if (row == StandTable::npos)
         {
             std::cout << "Stand " << oldStandNameUpper << " does not exist." << std::endl;
+            return;
         }
         std::string newStandName;
         std::cout << "Enter new stand name: ";
@@ -1084,15 +1252,13 @@ void renameStand(nlohmann::ordered_json &configJson, const std::string &standNam
             std::cout << RED << "New stand name cannot be empty." << RESET << std::endl;
             return;
         }
-        if (configJson["Stands"].contains(newStandNameUpper))
+        if (!stands.rename(row, newStandNameUpper))
         {
             std::cout << RED << "Stand " << newStandNameUpper << " already exists." << RESET << std::endl;
             return;
         }
         else
         {
-            configJson["Stands"][newStandNameUpper] = configJson["Stands"][oldStandNameUpper];
-            configJson["Stands"].erase(oldStandNameUpper);
             std::cout << "Stand " << oldStandNameUpper << " renamed to " << newStandNameUpper << "." << std::endl;
         }
     }
@@ -1102,14 +1268,15 @@ void renameStand(nlohmann::ordered_json &configJson, const std::string &standNam
     }
 }
 
-void editCode(nlohmann::ordered_json &configJson, const std::string &standName)
+void editCode(StandTable &stands, const std::string &standName)
 {
     std::string standNameUpper = standName;
     std::transform(standNameUpper.begin(), standNameUpper.end(), standNameUpper.begin(), ::toupper);
-    if (configJson.contains("Stands") && configJson["Stands"].is_object() && configJson["Stands"].contains(standNameUpper))
+    uint32_t row = stands.find(standNameUpper);
+    if (row != StandTable::npos)
     {
-        nlohmann::ordered_json &standJson = configJson["Stands"][standNameUpper];
-        std::cout << "Current code for stand " << standNameUpper << ": " << (standJson.contains("Code") ? standJson["Code"].get<std::string>() : "none") << std::endl;
+        StandRecord stand = stands.record(row);
+        std::cout << "Current code for stand " << standNameUpper << ": " << (stand.code ? codeString(stand.code) : "none") << std::endl;
         std::cout << "Enter new code (empty to keep, r to remove): ";
         std::string code;
         while (true)
@@ -1121,7 +1288,7 @@ void editCode(nlohmann::ordered_json &configJson, const std::string &standName)
             }
             else if (code == "r" || code == "R")
             {
-                standJson.erase("Code");
+                stand.code = 0;
                 break;
             }
             else
@@ -1133,12 +1300,13 @@ void editCode(nlohmann::ordered_json &configJson, const std::string &standName)
                     std::cout << "Enter new code (empty to keep, r to remove): ";
                     continue;
                 }
-                standJson["Code"] = code;
+                stand.code = codeMask(code);
                 break;
             }
         }
+        stands.setRecord(row, stand);
         std::cout << "Stand " << standNameUpper << " code updated." << std::endl;
-        printStandInfo(standJson);
+        printStandInfo(stand);
         std::cout << std::endl;
     }
     else
@@ -1147,14 +1315,15 @@ void editCode(nlohmann::ordered_json &configJson, const std::string &standName)
     }
 }
 
-void editUse(nlohmann::ordered_json &configJson, const std::string &standName)
+void editUse(StandTable &stands, const std::string &standName)
 {
     std::string standNameUpper = standName;
     std::transform(standNameUpper.begin(), standNameUpper.end(), standNameUpper.begin(), ::toupper);
-    if (configJson.contains("Stands") && configJson["Stands"].is_object() && configJson["Stands"].contains(standNameUpper))
+    uint32_t row = stands.find(standNameUpper);
+    if (row != StandTable::npos)
     {
-        nlohmann::ordered_json &standJson = configJson["Stands"][standNameUpper];
-        std::cout << "Current use for stand " << standNameUpper << ": " << (standJson.contains("Use") ? standJson["Use"].get<std::string>() : "none") << std::endl;
+        StandRecord stand = stands.record(row);
+        std::cout << "Current use for stand " << standNameUpper << ": " << (stand.use ? useString(stand.use) : "none") << std::endl;
         std::cout << "Enter new use (single character, empty to keep, r to remove): ";
         std::string use;
         while (true)
@@ -1166,7 +1335,7 @@ void editUse(nlohmann::ordered_json &configJson, const std::string &standName)
             }
             else if (use == "r" || use == "R")
             {
-                standJson.erase("Use");
+                stand.use = 0;
                 break;
             }
             else
@@ -1178,12 +1347,13 @@ void editUse(nlohmann::ordered_json &configJson, const std::string &standName)
                     continue;
                 }
                 std::transform(use.begin(), use.end(), use.begin(), ::toupper);
-                standJson["Use"] = use;
+                stand.use = useMask(use);
                 break;
             }
         }
+        stands.setRecord(row, stand);
         std::cout << "Stand " << standNameUpper << " use updated." << std::endl;
-        printStandInfo(standJson);
+        printStandInfo(stand);
         std::cout << std::endl;
     }
     else
@@ -1192,14 +1362,15 @@ void editUse(nlohmann::ordered_json &configJson, const std::string &standName)
     }
 }
 
-void editSchengen(nlohmann::ordered_json &configJson, const std::string &standName)
+void editSchengen(StandTable &stands, const std::string &standName)
 {
     std::string standNameUpper = standName;
     std::transform(standNameUpper.begin(), standNameUpper.end(), standNameUpper.begin(), ::toupper);
-    if (configJson.contains("Stands") && configJson["Stands"].is_object() && configJson["Stands"].contains(standNameUpper))
+    uint32_t row = stands.find(standNameUpper);
+    if (row != StandTable::npos)
     {
-        nlohmann::ordered_json &standJson = configJson["Stands"][standNameUpper];
-        std::cout << "Current Schengen status for stand " << standNameUpper << ": " << (standJson.contains("Schengen") ? (standJson["Schengen"].get<bool>() ? "Yes" : "No") : "none") << std::endl;
+        StandRecord stand = stands.record(row);
+        std::cout << "Current Schengen status for stand " << standNameUpper << ": " << (stand.schengen != Schengen::Unset ? (stand.schengen == Schengen::Yes ? "Yes" : "No") : "none") << std::endl;
         std::cout << "Is it a Schengen stand? (Y/N, empty to keep, r to remove): ";
         std::string schengen;
         while (true)
@@ -1211,17 +1382,17 @@ void editSchengen(nlohmann::ordered_json &configJson, const std::string &standNa
             }
             else if (schengen == "r" || schengen == "R")
             {
-                standJson.erase("Schengen");
+                stand.schengen = Schengen::Unset;
                 break;
             }
             else if (schengen == "Y" || schengen == "y")
             {
-                standJson["Schengen"] = true;
+                stand.schengen = Schengen::Yes;
                 break;
             }
             else if (schengen == "N" || schengen == "n")
             {
-                standJson["Schengen"] = false;
+                stand.schengen = Schengen::No;
                 break;
             }
             else
@@ -1229,8 +1400,9 @@ void editSchengen(nlohmann::ordered_json &configJson, const std::string &standNa
                 std::cout << RED << "Invalid input. Please enter 'Y', 'N', 'R' to remove or leave empty to keep." << RESET << std::endl;
             }
         }
+        stands.setRecord(row, stand);
         std::cout << "Stand " << standNameUpper << " Schengen status updated." << std::endl;
-        printStandInfo(standJson);
+        printStandInfo(stand);
         std::cout << std::endl;
     }
     else
@@ -1239,19 +1411,20 @@ void editSchengen(nlohmann::ordered_json &configJson, const std::string &standNa
     }
 }
 
-void editCallsigns(nlohmann::ordered_json &configJson, const std::string &standName)
+void editCallsigns(StandTable &stands, const std::string &standName)
 {
     std::string standNameUpper = standName;
     std::transform(standNameUpper.begin(), standNameUpper.end(), standNameUpper.begin(), ::toupper);
-    if (configJson.contains("Stands") && configJson["Stands"].is_object() && configJson["Stands"].contains(standNameUpper))
+    uint32_t row = stands.find(standNameUpper);
+    if (row != StandTable::npos)
     {
-        nlohmann::ordered_json &standJson = configJson["Stands"][standNameUpper];
+        StandRecord stand = stands.record(row);
         std::cout << "Current callsigns for stand " << standNameUpper << ": ";
-        if (standJson.contains("Callsigns"))
+        if (!stand.callsigns.empty())
         {
-            for (const auto &cs : standJson["Callsigns"])
+            for (const auto &cs : stand.callsigns)
             {
-                std::cout << cs << " ";
+                std::cout << std::quoted(cs) << " ";
             }
         }
         else
@@ -1270,7 +1443,7 @@ void editCallsigns(nlohmann::ordered_json &configJson, const std::string &standN
             }
             else if (callsignsInput == "r" || callsignsInput == "R")
             {
-                standJson.erase("Callsigns");
+                stand.callsigns.clear();
                 break;
             }
             else
@@ -1278,17 +1451,18 @@ void editCallsigns(nlohmann::ordered_json &configJson, const std::string &standN
                 std::vector<std::string> callsigns = splitString(callsignsInput);
                 if (!callsigns.empty())
                 {
-                    standJson["Callsigns"] = callsigns;
+                    stand.callsigns = callsigns;
                 }
                 else
                 {
-                    standJson.erase("Callsigns");
+                    stand.callsigns.clear();
                 }
                 break;
             }
         }
+        stands.setRecord(row, stand);
         std::cout << "Stand " << standNameUpper << " callsigns updated." << std::endl;
-        printStandInfo(standJson);
+        printStandInfo(stand);
         std::cout << std::endl;
     }
     else
@@ -1297,19 +1471,20 @@ void editCallsigns(nlohmann::ordered_json &configJson, const std::string &standN
     }
 }
 
-void editCountries(nlohmann::ordered_json &configJson, const std::string &standName)
+void editCountries(StandTable &stands, const std::string &standName)
 {
     std::string standNameUpper = standName;
     std::transform(standNameUpper.begin(), standNameUpper.end(), standNameUpper.begin(), ::toupper);
-    if (configJson.contains("Stands") && configJson["Stands"].is_object() && configJson["Stands"].contains(standNameUpper))
+    uint32_t row = stands.find(standNameUpper);
+    if (row != StandTable::npos)
     {
-        nlohmann::ordered_json &standJson = configJson["Stands"][standNameUpper];
+        StandRecord stand = stands.record(row);
         std::cout << "Current countries for stand " << standNameUpper << ": ";
-        if (standJson.contains("Countries"))
+        if (!stand.countries.empty())
         {
-            for (const auto &country : standJson["Countries"])
+            for (const auto &country : stand.countries)
             {
-                std::cout << country << " ";
+                std::cout << std::quoted(country) << " ";
             }
         }
         else
@@ -1328,7 +1503,7 @@ void editCountries(nlohmann::ordered_json &configJson, const std::string &standN
             }
             else if (countriesInput == "r" || countriesInput == "R")
             {
-                standJson.erase("Countries");
+                stand.countries.clear();
                 break;
             }
             else
@@ -1336,17 +1511,18 @@ void editCountries(nlohmann::ordered_json &configJson, const std::string &standN
                 std::vector<std::string> countries = splitString(countriesInput);
                 if (!countries.empty())
                 {
-                    standJson["Countries"] = countries;
+                    stand.countries = countries;
                 }
                 else
                 {
-                    standJson.erase("Countries");
+                    stand.countries.clear();
                 }
                 break;
             }
         }
+        stands.setRecord(row, stand);
         std::cout << "Stand " << standNameUpper << " countries updated." << std::endl;
-        printStandInfo(standJson);
+        printStandInfo(stand);
         std::cout << std::endl;
     }
     else
@@ -1355,19 +1531,20 @@ void editCountries(nlohmann::ordered_json &configJson, const std::string &standN
     }
 }
 
-void editBlock(nlohmann::ordered_json &configJson, const std::string &standName)
+void editBlock(StandTable &stands, const std::string &standName)
 {
     std::string standNameUpper = standName;
     std::transform(standNameUpper.begin(), standNameUpper.end(), standNameUpper.begin(), ::toupper);
-    if (configJson.contains("Stands") && configJson["Stands"].is_object() && configJson["Stands"].contains(standNameUpper))
+    uint32_t row = stands.find(standNameUpper);
+    if (row != StandTable::npos)
     {
-        nlohmann::ordered_json &standJson = configJson["Stands"][standNameUpper];
+        StandRecord stand = stands.record(row);
         std::cout << "Current blocked stands for stand " << standNameUpper << ": ";
-        if (standJson.contains("Block"))
+        if (!stand.block.empty())
         {
-            for (const auto &blk : standJson["Block"])
+            for (const auto &blk : stand.block)
             {
-                std::cout << blk << " ";
+                std::cout << std::quoted(blk) << " ";
             }
         }
         else
@@ -1386,7 +1563,7 @@ void editBlock(nlohmann::ordered_json &configJson, const std::string &standName)
             }
             else if (blockInput == "r" || blockInput == "R")
             {
-                standJson.erase("Block");
+                stand.block.clear();
                 break;
             }
             else
@@ -1394,17 +1571,18 @@ void editBlock(nlohmann::ordered_json &configJson, const std::string &standName)
                 std::vector<std::string> blocked = splitString(blockInput);
                 if (!blocked.empty())
                 {
-                    standJson["Block"] = blocked;
+                    stand.block = blocked;
                 }
                 else
                 {
-                    standJson.erase("Block");
+                    stand.block.clear();
                 }
                 break;
             }
         }
+        stands.setRecord(row, stand);
         std::cout << "Stand " << standNameUpper << " blocked stands updated." << std::endl;
-        printStandInfo(standJson);
+        printStandInfo(stand);
         std::cout << std::endl;
     }
     else
@@ -1413,14 +1591,15 @@ void editBlock(nlohmann::ordered_json &configJson, const std::string &standName)
     }
 }
 
-void editWingspan(nlohmann::ordered_json &configJson, const std::string &standName)
+void editWingspan(StandTable &stands, const std::string &standName)
 {
     std::string standNameUpper = standName;
     std::transform(standNameUpper.begin(), standNameUpper.end(), standNameUpper.begin(), ::toupper);
-    if (configJson.contains("Stands") && configJson["Stands"].is_object() && configJson["Stands"].contains(standNameUpper))
+    uint32_t row = stands.find(standNameUpper);
+    if (row != StandTable::npos)
     {
-        nlohmann::ordered_json &standJson = configJson["Stands"][standNameUpper];
-        std::cout << "Current max Wingspan for stand " << standNameUpper << ": " << (standJson.contains("Wingspan") ? std::to_string(standJson["Wingspan"].get<int>()) : "none") << std::endl;
+        StandRecord stand = stands.record(row);
+        std::cout << "Current max Wingspan for stand " << standNameUpper << ": " << (stand.wingspan ? std::to_string(*stand.wingspan) : "none") << std::endl;
         std::cout << "Enter new max Wingspan (integer, empty to keep, r to remove): ";
         std::string wingspanInput;
         while (true)
@@ -1432,7 +1611,7 @@ void editWingspan(nlohmann::ordered_json &configJson, const std::string &standNa
             }
             else if (wingspanInput == "r" || wingspanInput == "R")
             {
-                standJson.erase("Wingspan");
+                stand.wingspan.reset();
                 break;
             }
             else
@@ -1440,7 +1619,7 @@ void editWingspan(nlohmann::ordered_json &configJson, const std::string &standNa
                 try
                 {
                     int wingspan = std::stoi(wingspanInput);
-                    standJson["Wingspan"] = wingspan;
+                    stand.wingspan = wingspan;
                     break;
                 }
                 catch (const std::exception &e)
@@ -1451,8 +1630,9 @@ void editWingspan(nlohmann::ordered_json &configJson, const std::string &standNa
                 }
             }
         }
+        stands.setRecord(row, stand);
         std::cout << "Stand " << standNameUpper << " max Wingspan updated." << std::endl;
-        printStandInfo(standJson);
+        printStandInfo(stand);
         std::cout << std::endl;
     }
     else
@@ -1461,19 +1641,20 @@ void editWingspan(nlohmann::ordered_json &configJson, const std::string &standNa
     }
 }
 
-void editRemark(nlohmann::ordered_json &configJson, const std::string &standName)
+void editRemark(StandTable &stands, const std::string &standName)
 {
     std::string standNameUpper = standName;
     std::transform(standNameUpper.begin(), standNameUpper.end(), standNameUpper.begin(), ::toupper);
-    if (configJson.contains("Stands") && configJson["Stands"].is_object() && configJson["Stands"].contains(standNameUpper))
+    uint32_t row = stands.find(standNameUpper);
+    if (row != StandTable::npos)
     {
-        nlohmann::ordered_json &standJson = configJson["Stands"][standNameUpper];
+        StandRecord stand = stands.record(row);
         std::cout << "Current Remark for stand " << standNameUpper << ": ";
-        if (standJson.contains("Remark"))
+        if (!stand.remarks.empty())
         {
-            for (const auto &[key, value] : standJson["Remark"].items())
+            for (const auto &[key, value] : stand.remarks)
             {
-                std::cout << key << " : " << value << " ";
+                std::cout << key << " : " << std::quoted(value) << " ";
             }
         }
         else
@@ -1492,35 +1673,18 @@ void editRemark(nlohmann::ordered_json &configJson, const std::string &standName
             }
             else if (remarkInput == "r" || remarkInput == "R")
             {
-                standJson.erase("Remark");
+                stand.remarks.clear();
                 break;
             }
             else
             {
-                std::vector<std::string> remarks = splitRemark(remarkInput);
-                if (!remarks.empty())
-                {
-                    nlohmann::ordered_json newRemarks;
-                    for (const auto &remark : remarks)
-                    {
-                        size_t colonPos = remark.find(':');
-                        std::string key = remark.substr(0, colonPos);
-                        key.erase(std::remove_if(key.begin(), key.end(), ::isspace), key.end());
-                        std::transform(key.begin(), key.end(), key.begin(), ::toupper);
-                        std::string value = remark.substr(colonPos + 1);
-                        newRemarks[key] = value;
-                    }
-                    standJson["Remark"] = newRemarks;
-                }
-                else
-                {
-                    standJson.erase("Remark");
-                }
+                stand.remarks = parseRemarks(remarkInput);
                 break;
             }
         }
+        stands.setRecord(row, stand);
         std::cout << "Stand " << standNameUpper << " Remark updated." << std::endl;
-        printStandInfo(standJson);
+        printStandInfo(stand);
         std::cout << std::endl;
     }
     else
@@ -1529,14 +1693,15 @@ void editRemark(nlohmann::ordered_json &configJson, const std::string &standName
     }
 }
 
-void editPriority(nlohmann::ordered_json &configJson, const std::string &standName)
+void editPriority(StandTable &stands, const std::string &standName)
 {
     std::string standNameUpper = standName;
     std::transform(standNameUpper.begin(), standNameUpper.end(), standNameUpper.begin(), ::toupper);
-    if (configJson.contains("Stands") && configJson["Stands"].is_object() && configJson["Stands"].contains(standNameUpper))
+    uint32_t row = stands.find(standNameUpper);
+    if (row != StandTable::npos)
     {
-        nlohmann::ordered_json &standJson = configJson["Stands"][standNameUpper];
-        std::cout << "Current priority for stand " << standNameUpper << ": " << (standJson.contains("Priority") ? std::to_string(standJson["Priority"].get<int>()) : "none") << std::endl;
+        StandRecord stand = stands.record(row);
+        std::cout << "Current priority for stand " << standNameUpper << ": " << (stand.priority ? std::to_string(*stand.priority) : "none") << std::endl;
         std::cout << "Enter new priority (integer, empty to keep, r to remove): ";
         std::string priorityInput;
         while (true)
@@ -1548,7 +1713,7 @@ void editPriority(nlohmann::ordered_json &configJson, const std::string &standNa
             }
             else if (priorityInput == "r" || priorityInput == "R")
             {
-                standJson.erase("Priority");
+                stand.priority.reset();
                 break;
             }
             else
@@ -1556,7 +1721,7 @@ void editPriority(nlohmann::ordered_json &configJson, const std::string &standNa
                 try
                 {
                     int priority = std::stoi(priorityInput);
-                    standJson["Priority"] = priority;
+                    stand.priority = priority;
                     break;
                 }
                 catch (const std::exception &e)
@@ -1567,8 +1732,9 @@ void editPriority(nlohmann::ordered_json &configJson, const std::string &standNa
                 }
             }
         }
+        stands.setRecord(row, stand);
         std::cout << "Stand " << standNameUpper << " priority updated." << std::endl;
-        printStandInfo(standJson);
+        printStandInfo(stand);
         std::cout << std::endl;
     }
     else
@@ -1577,14 +1743,15 @@ void editPriority(nlohmann::ordered_json &configJson, const std::string &standNa
     }
 }
 
-void editApron(nlohmann::ordered_json &configJson, const std::string &standName)
+void editApron(StandTable &stands, const std::string &standName)
 {
     std::string standNameUpper = standName;
     std::transform(standNameUpper.begin(), standNameUpper.end(), standNameUpper.begin(), ::toupper);
-    if (configJson.contains("Stands") && configJson["Stands"].is_object() && configJson["Stands"].contains(standNameUpper))
+    uint32_t row = stands.find(standNameUpper);
+    if (row != StandTable::npos)
     {
-        nlohmann::ordered_json &standJson = configJson["Stands"][standNameUpper];
-        std::cout << "Current apron status for stand " << standNameUpper << ": " << (standJson.contains("Apron") ? "Yes" : "No") << std::endl;
+        StandRecord stand = stands.record(row);
+        std::cout << "Current apron status for stand " << standNameUpper << ": " << (stand.isApron() ? "Yes" : "No") << std::endl;
         std::cout << "Is it an apron stand? (Y if apron, empty to keep, r to remove): ";
         std::string apronInput;
         while (true)
@@ -1596,7 +1763,8 @@ void editApron(nlohmann::ordered_json &configJson, const std::string &standName)
             }
             else if (apronInput == "r" || apronInput == "R")
             {
-                standJson.erase("Apron");
+                stand.apron.reset();
+                stand.extra.erase("Apron");
                 break;
             }
             else if (apronInput == "Y" || apronInput == "y")
@@ -1618,7 +1786,10 @@ void editApron(nlohmann::ordered_json &configJson, const std::string &standName)
                     }
                     else
                     {
-                        standJson["Apron"]["Size"] = std::stoi(size);
+                        if (!stand.apron)
+                            stand.apron.emplace();
+                        stand.apron->size = std::stoi(size);
+                        stand.extra.erase("Apron");
                         break;
                     }
                 }
@@ -1645,15 +1816,16 @@ void editApron(nlohmann::ordered_json &configJson, const std::string &standName)
                         }
                     }
                 }
-                standJson["Apron"]["Coordinates"] = coordinatesList;
+                stand.apron->coordinates = coordinatesList;
             }
             else
             {
                 std::cout << RED << "Invalid input. Please enter 'Y', 'N', 'R' to remove or leave empty to keep." << RESET << std::endl;
             }
         }
+        stands.setRecord(row, stand);
         std::cout << "Stand " << standNameUpper << " apron status updated." << std::endl;
-        printStandInfo(standJson);
+        printStandInfo(stand);
         std::cout << std::endl;
     }
     else
@@ -1,28 +1,33 @@
 #pragma once
 #include "nlohmann/json.hpp"
+#include "stand_table.h"
 #include <string>
 
 void printMenu();
-void printStandInfo(const nlohmann::ordered_json &standJson);
-void listAllStands(const nlohmann::ordered_json &configJson);
-void addStand(nlohmann::ordered_json &configJson, const std::string &standName);
-void removeStand(nlohmann::ordered_json &configJson, const std::string &standName);
-void editStand(nlohmann::ordered_json &configJson, const std::string &standName);
-void copyStand(nlohmann::ordered_json &configJson, const std::string &standName);
-void batchcopy(nlohmann::ordered_json &configJson, const std::string &standName);
-void softStandCopy(nlohmann::ordered_json &configJson, const std::string &standName);
+void printStandInfo(const StandRecord &stand);
+void listAllStands(const StandTable &stands);
+void filterStands(const StandTable &stands, const std::string &query);
+void nearestStands(const StandTable &stands, const std::string &position);
+void standsWithin(const StandTable &stands, const std::string &area);
+void listOverlaps(const StandTable &stands, const std::string &icao, bool exportList);
+void addStand(StandTable &stands, const std::string &standName);
+void removeStand(StandTable &stands, const std::string &standName);
+void editStand(StandTable &stands, const std::string &standName);
+void copyStand(StandTable &stands, const std::string &standName);
+void batchcopy(StandTable &stands, const std::string &standName);
+void softStandCopy(StandTable &stands, const std::string &standName);
 
-void editStandRadius(nlohmann::ordered_json &configJson, const std::string &standName);
-void editBlock(nlohmann::ordered_json &configJson, const std::string &standName);
-void editCountries(nlohmann::ordered_json &configJson, const std::string &standName);
-void editCallsigns(nlohmann::ordered_json &configJson, const std::string &standName);
-void editRemark(nlohmann::ordered_json &configJson, const std::string &standName);
-void editCode(nlohmann::ordered_json &configJson, const std::string &standName);
-void editUse(nlohmann::ordered_json &configJson, const std::string &standName);
-void editSchengen(nlohmann::ordered_json &configJson, const std::string &standName);
-void editWingspan(nlohmann::ordered_json &configJson, const std::string &standName);
-void editPriority(nlohmann::ordered_json &configJson, const std::string &standName);
-void editApron(nlohmann::ordered_json &configJson, const std::string &standName);
-void renameStand(nlohmann::ordered_json &configJson, const std::string &standName);
+void editStandRadius(StandTable &stands, const std::string &standName);
+void editBlock(StandTable &stands, const std::string &standName);
+void editCountries(StandTable &stands, const std::string &standName);
+void editCallsigns(StandTable &stands, const std::string &standName);
+void editRemark(StandTable &stands, const std::string &standName);
+void editCode(StandTable &stands, const std::string &standName);
+void editUse(StandTable &stands, const std::string &standName);
+void editSchengen(StandTable &stands, const std::string &standName);
+void editWingspan(StandTable &stands, const std::string &standName);
+void editPriority(StandTable &stands, const std::string &standName);
+void editApron(StandTable &stands, const std::string &standName);
+void renameStand(StandTable &stands, const std::string &standName);
 
-void iterateAndModifyStandSettings(nlohmann::ordered_json &configJson, const std::string& newStandName);
+void iterateAndModifyStandSettings(StandRecord &stand, const std::string& newStandName);
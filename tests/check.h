@@ -0,0 +1,17 @@
+#pragma once
+// Shared by the programs in tests/: each check that fails is reported and counted, and
+// main returns non-zero when any did
+#include "utils.h"
+#include <iostream>
+#include <string>
+
+inline int failures = 0;
+
+inline void check(bool condition, const std::string &what)
+{
+    if (!condition)
+    {
+        std::cout << RED << "FAIL: " << what << RESET << std::endl;
+        failures++;
+    }
+}
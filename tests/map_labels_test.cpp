@@ -0,0 +1,136 @@
+// Label sets of the map render: every zoom the page may ask for has a set, or none is
+// needed at all, and the page's labelShown reads them without failing (run under node
+// when it is installed). Build and run with: make test
+#include "map_generator.h"
+#include "stand_table.h"
+#include "utils.h"
+#include "check.h"
+#include "nlohmann/json.hpp"
+#include <filesystem>
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+namespace
+{
+    void addStand(StandTable &stands, const std::string &name, double lat, double lon)
+    {
+        StandRecord stand;
+        stand.hasCoordinates = true;
+        stand.coordinates = {lat, lon, 30, true};
+        stands.insert(name, stand);
+    }
+
+    nlohmann::json renderLabels(const StandTable &stands, const std::string &icao)
+    {
+        check(writeMap(stands, icao), icao + ": map written");
+        std::ifstream file(icao + "_stands.json");
+        nlohmann::json data = nlohmann::json::parse(file);
+        return data["labels"];
+    }
+
+    // The page reads sets[zoom - from] below full; an empty list must mean every label
+    // is shown at every zoom
+    void checkShape(const nlohmann::json &labels, const std::string &icao)
+    {
+        int from = labels["from"];
+        int full = labels["full"];
+        check(full >= from, icao + ": full is not below from");
+        check(labels["sets"].size() == static_cast<size_t>(full - from), icao + ": one set per zoom from from to full");
+    }
+
+    bool hasNode()
+    {
+        return std::system("node --version > /dev/null 2>&1") == 0;
+    }
+
+    // Runs the page's setLabels and labelShown over the rendered stands and returns how
+    // many labels show at each zoom from 0 to 22, or an empty list when the script failed
+    nlohmann::json shownPerZoom(const std::string &icao)
+    {
+        std::ifstream pageFile(icao + "_map.html");
+        std::stringstream page;
+        page << pageFile.rdbuf();
+        std::string html = page.str();
+        size_t begin = html.find("function setLabels(");
+        size_t shown = html.find("function labelShown(", begin);
+        size_t end = html.find("\n        }\n", shown);
+        check(begin != std::string::npos && shown != std::string::npos && end != std::string::npos, icao + ": page has setLabels and labelShown");
+        if (begin == std::string::npos || shown == std::string::npos || end == std::string::npos)
+            return nlohmann::json::array();
+
+        std::ofstream script(icao + "_labels.js");
+        script << "var map = { zoom: 0, getZoom: function() { return this.zoom; } };\n"
+               << "var standLabels = null, labelBits = [];\n"
+               << html.substr(begin, end + 10 - begin) << "\n"
+               << "var data = JSON.parse(require('fs').readFileSync('" << icao << "_stands.json', 'utf8'));\n"
+               << "setLabels(data.labels);\n"
+               << "var counts = [];\n"
+               << "for (map.zoom = 0; map.zoom <= 22; map.zoom++)\n"
+               << "    counts.push(data.stands.filter(function(row) { return labelShown({ row: row }); }).length);\n"
+               << "console.log(JSON.stringify(counts));\n";
+        script.close();
+        if (std::system(("node " + icao + "_labels.js > " + icao + "_labels.out 2>&1").c_str()) != 0)
+        {
+            check(false, icao + ": labelShown ran under node");
+            return nlohmann::json::array();
+        }
+        std::ifstream output(icao + "_labels.out");
+        return nlohmann::json::parse(output, nullptr, false);
+    }
+}
+
+int main()
+{
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / "map_labels_test";
+    std::filesystem::create_directories(directory);
+    std::filesystem::current_path(directory);
+
+    // Two stands kilometers apart: every label fits from the first zoom on
+    StandTable sparse;
+    addStand(sparse, "A1", 43.6500, 7.2000);
+    addStand(sparse, "B1", 43.6700, 7.2300);
+    nlohmann::json labels = renderLabels(sparse, "SPRS");
+    checkShape(labels, "SPRS");
+    check(labels["sets"].empty() && labels["full"] == labels["from"], "SPRS: no sets when nothing overlaps");
+    bool node = hasNode();
+    if (node)
+    {
+        nlohmann::json counts = shownPerZoom("SPRS");
+        check(counts.size() == 23, "SPRS: labelShown answered for every zoom");
+        for (const auto &count : counts)
+            check(count == 2, "SPRS: every label shown at every zoom without sets");
+    }
+    else
+        std::cout << YELLOW << "node not found, labelShown is not run" << RESET << std::endl;
+
+    // Neighbours a few meters apart overlap until deep zooms
+    StandTable dense;
+    for (int i = 0; i < 20; i++)
+        addStand(dense, "S" + std::to_string(i), 43.66 + i * 0.0002, 7.21);
+    labels = renderLabels(dense, "DNSE");
+    checkShape(labels, "DNSE");
+    check(!labels["sets"].empty(), "DNSE: overlapping labels get sets");
+    if (node)
+    {
+        nlohmann::json counts = shownPerZoom("DNSE");
+        int from = labels["from"];
+        int full = labels["full"];
+        check(counts.size() == 23, "DNSE: labelShown answered for every zoom");
+        if (counts.size() == 23)
+        {
+            check(counts[from] < 20, "DNSE: labels are hidden below full");
+            check(counts[std::min(full, 22)] == 20, "DNSE: every label shown from full on");
+        }
+    }
+
+    std::filesystem::current_path(std::filesystem::temp_directory_path());
+    std::filesystem::remove_all(directory);
+    if (failures)
+        return 1;
+    std::cout << GREEN << "map labels: ok" << RESET << std::endl;
+    return 0;
+}
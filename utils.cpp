@@ -2,8 +2,11 @@
 #include <algorithm>
 #include <sstream>
 #include <filesystem>
-#include <regex>
+#include <charconv>
+#include <cstdlib>
 #include <iostream>
+#include <cstdio>
+#include <cctype>
 #ifdef _WIN32
 #ifndef NOMINMAX
 #define NOMINMAX
@@ -83,170 +86,456 @@ std::string getBaseDir() {
     return execDir;
 }
 
-bool isCoordinatesValid(std::string &coordinates, bool radius)
+namespace
 {
-    // Remove "COORD:" prefix if present
-    if (coordinates.substr(0, 6) == "COORD:")
+    // Converts a span already checked by scanNumber, the sign is handled by the caller
+    double toDouble(const char *begin, const char *end)
     {
-        coordinates = coordinates.substr(6);
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+        double value = 0;
+        std::from_chars(begin, end, value);
+        return value;
+#else
+        return std::strtod(std::string(begin, end).c_str(), nullptr);
+#endif
     }
-    
-    // Basic validation of Degree decimal format
-    size_t firstColon = coordinates.find(':');
-    size_t secondColon = coordinates.find(':', firstColon + 1);
-    if (firstColon == std::string::npos || (secondColon == std::string::npos && radius))
+
+    bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+    // digits [. digits] [e [+-] digits], advances p past the number
+    bool scanNumber(const char *&p, const char *end, double &value)
     {
-        return false;
+        const char *start = p;
+        const char *q = p;
+        while (q != end && isDigit(*q))
+            q++;
+        bool digits = q != start;
+        if (q != end && *q == '.')
+        {
+            const char *fraction = ++q;
+            while (q != end && isDigit(*q))
+                q++;
+            digits = digits || q != fraction;
+        }
+        if (!digits)
+            return false;
+        if (q != end && (*q == 'e' || *q == 'E'))
+        {
+            const char *exponent = q + 1;
+            if (exponent != end && (*exponent == '+' || *exponent == '-'))
+                exponent++;
+            if (exponent == end || !isDigit(*exponent))
+                return false;
+            while (exponent != end && isDigit(*exponent))
+                exponent++;
+            q = exponent;
+        }
+        value = toDouble(start, q);
+        p = q;
+        return true;
     }
-    
-    // Check if already in decimal format - allow empty radius
-    std::regex degreeDecimalRegex;
-    if (radius == false)
-    {
-        secondColon = coordinates.length();
-        degreeDecimalRegex = R"(([-+]?\d{1,3}\.\d+):([-+]?\d{1,3}\.\d+))";
-    } else {
-        degreeDecimalRegex = R"(([-+]?\d{1,3}\.\d+):([-+]?\d{1,3}\.\d+):(\d*))";
-    }
-    if (std::regex_match(coordinates, degreeDecimalRegex))
-    {
-        // Valid format : 43.666359:7.216941:20
-        std::string lat = coordinates.substr(0, firstColon);
-        std::string lon = coordinates.substr(firstColon + 1, secondColon - firstColon - 1);
-        std::string radius_;
-        if (radius == false) {
-            radius_ = "";
-        } else {
-            radius_ = coordinates.substr(secondColon + 1);
+
+    // Exactly width digits
+    bool scanFixed(const char *&p, const char *end, int width, int &value)
+    {
+        value = 0;
+        for (int i = 0; i < width; i++, p++)
+        {
+            if (p == end || !isDigit(*p))
+                return false;
+            value = value * 10 + (*p - '0');
         }
-        try
+        return true;
+    }
+
+    bool skip(const char *&p, const char *end, char c)
+    {
+        if (p == end || *p != c)
+            return false;
+        p++;
+        return true;
+    }
+
+    // One latitude or longitude, decimal or DMS (N043.37.40.861), range not checked.
+    // Returns the reason of the first error with p left on it, nullptr on success
+    const char *scanAxis(const char *&p, const char *end, bool latitude, double &value, bool &dms)
+    {
+        if (p != end && (*p == (latitude ? 'N' : 'E') || *p == (latitude ? 'S' : 'W')))
         {
-            double latVal = std::stod(lat);
-            double lonVal = std::stod(lon);
-            if (latVal < -90 || latVal > 90 || lonVal < -180 || lonVal > 180)
+            bool negative = *p == 'S' || *p == 'W';
+            int degrees, minutes, seconds, millis;
+            p++;
+            if (!scanFixed(p, end, 3, degrees))
+                return "expected 3 digits of degrees";
+            if (!skip(p, end, '.'))
+                return "expected '.' after degrees";
+            if (!scanFixed(p, end, 2, minutes))
+                return "expected 2 digits of minutes";
+            if (minutes >= 60)
             {
-                return false;
+                p -= 2;
+                return "minutes must be below 60";
             }
-            // Validate radius if provided
-            if (!radius_.empty())
+            if (!skip(p, end, '.'))
+                return "expected '.' after minutes";
+            if (!scanFixed(p, end, 2, seconds))
+                return "expected 2 digits of seconds";
+            if (seconds >= 60)
             {
-                double radiusVal = std::stod(radius_);
-                if (radiusVal < 9)
-                {
-                    return false;
-                }
+                p -= 2;
+                return "seconds must be below 60";
             }
-            return true;
+            if (!skip(p, end, '.'))
+                return "expected '.' after seconds";
+            if (!scanFixed(p, end, 3, millis))
+                return "expected 3 digits of milliseconds";
+            value = degrees + minutes / 60.0 + (seconds + millis / 1000.0) / 3600.0;
+            if (negative)
+                value = -value;
+            dms = true;
+            return nullptr;
         }
-        catch (...)
+        bool negative = p != end && *p == '-';
+        if (p != end && (*p == '-' || *p == '+'))
+            p++;
+        if (!scanNumber(p, end, value))
+            return latitude ? "expected latitude" : "expected longitude";
+        if (negative)
+            value = -value;
+        return nullptr;
+    }
+
+    enum class Field
+    {
+        Prefix,
+        Latitude,
+        Longitude,
+        Radius,
+        Done
+    };
+
+    CoordinateParse scanCoordinates(std::string_view text, bool radius, double minRadius)
+    {
+        CoordinateParse result;
+        const char *begin = text.data();
+        const char *end = begin + text.size();
+        const char *p = begin;
+        auto fail = [&](const char *at, const char *error)
         {
-            return false;
+            result.errorPos = static_cast<size_t>(at - begin);
+            result.error = error;
+            return result;
+        };
+
+        Field field = Field::Prefix;
+        while (field != Field::Done)
+        {
+            switch (field)
+            {
+            case Field::Prefix:
+                if (text.substr(0, 6) == "COORD:")
+                    p += 6;
+                field = Field::Latitude;
+                break;
+
+            case Field::Latitude:
+            case Field::Longitude:
+            {
+                bool latitude = field == Field::Latitude;
+                const char *start = p;
+                double value = 0;
+                if (const char *error = scanAxis(p, end, latitude, value, result.dms))
+                    return fail(p, error);
+
+                if (latitude)
+                {
+                    if (value < -90 || value > 90)
+                        return fail(start, "latitude must be between -90 and 90");
+                    result.coordinates.lat = value;
+                    if (!skip(p, end, ':'))
+                        return fail(p, "expected ':' after latitude");
+                    field = Field::Longitude;
+                }
+                else
+                {
+                    if (value < -180 || value > 180)
+                        return fail(start, "longitude must be between -180 and 180");
+                    result.coordinates.lon = value;
+                    if (p == end && !radius)
+                    {
+                        field = Field::Done;
+                        break;
+                    }
+                    if (!skip(p, end, ':'))
+                        return fail(p, radius ? "expected ':' before radius" : "expected ':' or end after longitude");
+                    field = Field::Radius;
+                }
+                break;
+            }
+
+            case Field::Radius:
+                // May be left empty, the stand then uses the default radius
+                if (p != end)
+                {
+                    const char *start = p;
+                    double value = 0;
+                    if (!scanNumber(p, end, value))
+                        return fail(p, "expected radius in meters");
+                    if (value < minRadius)
+                        return fail(start, "radius must be at least 9 meters");
+                    result.coordinates.radius = value;
+                    result.coordinates.hasRadius = true;
+                }
+                field = Field::Done;
+                break;
+
+            case Field::Done:
+                break;
+            }
         }
+        if (p != end)
+            return fail(p, "unexpected character");
+        result.ok = true;
+        return result;
+    }
+}
+
+bool parseCoordinateAxis(std::string_view text, bool latitude, double &value)
+{
+    const char *p = text.data();
+    const char *end = p + text.size();
+    bool dms = false;
+    return !scanAxis(p, end, latitude, value, dms) && p == end;
+}
+
+bool parseCoordinateNumber(std::string_view text, double &value)
+{
+    const char *p = text.data();
+    const char *end = p + text.size();
+    return scanNumber(p, end, value) && p == end;
+}
+
+CoordinateParse parseCoordinateText(std::string_view text, bool radius)
+{
+    return scanCoordinates(text, radius, MIN_RADIUS);
+}
+
+bool isCoordinatesValid(std::string &coordinates, bool radius)
+{
+    CoordinateParse parse = parseCoordinateText(coordinates, radius);
+    if (!parse.ok)
+        return false;
+    if (parse.dms)
+    {
+        // Stored as decimal, with enough digits to keep the millisecond precision
+        const Coordinates &c = parse.coordinates;
+        coordinates = formatNumber(c.lat) + ":" + formatNumber(c.lon);
+        if (radius || c.hasRadius)
+            coordinates += ":" + (c.hasRadius ? formatNumber(c.radius) : std::string());
     }
-    
-    // Try to convert from DMS format like N043.37.40.861:E001.22.36.064:25 or COORD:N043.37.40.861:E001.22.36.064:25
-    std::regex dmsRegex(R"([NS](\d{3})\.(\d{2})\.(\d{2})\.(\d{3}):[EW](\d{3})\.(\d{2})\.(\d{2})\.(\d{3}):(\d+))");
-    std::smatch match;
-    if (std::regex_match(coordinates, match, dmsRegex))
-    {
-        // Convert latitude
-        int latDeg = std::stoi(match[1]);
-        int latMin = std::stoi(match[2]);
-        int latSec = std::stoi(match[3]);
-        int latMillisec = std::stoi(match[4]);
-        double latDecimal = latDeg + latMin / 60.0 + (latSec + latMillisec / 1000.0) / 3600.0;
-        if (coordinates[0] == 'S') latDecimal = -latDecimal;
-        
-        // Convert longitude
-        int lonDeg = std::stoi(match[5]);
-        int lonMin = std::stoi(match[6]);
-        int lonSec = std::stoi(match[7]);
-        int lonMillisec = std::stoi(match[8]);
-        double lonDecimal = lonDeg + lonMin / 60.0 + (lonSec + lonMillisec / 1000.0) / 3600.0;
-        if (coordinates.find("W") != std::string::npos) lonDecimal = -lonDecimal;
-        
-        std::string radius = match[9].str();
-        
-        // Validate ranges
-        if (latDecimal < -90 || latDecimal > 90 || lonDecimal < -180 || lonDecimal > 180)
+    else if (coordinates.compare(0, 6, "COORD:") == 0)
+    {
+        coordinates.erase(0, 6);
+    }
+    return true;
+}
+
+NaturalKey naturalKey(const std::string &standName)
+{
+    NaturalKey key;
+    std::string &bytes = key.bytes;
+    bytes.reserve(standName.size() * 2 + 4);
+    size_t i = 0;
+    while (i < standName.size())
+    {
+        size_t start = i;
+        if (std::isdigit(static_cast<unsigned char>(standName[i])))
         {
-            return false;
+            while (i < standName.size() && std::isdigit(static_cast<unsigned char>(standName[i])))
+                i++;
+            // Strip leading zeros so equal values encode equally, a longer run is a larger number
+            while (start + 1 < i && standName[start] == '0')
+                start++;
+            size_t digits = std::min<size_t>(i - start, 255);
+            bytes += '\x01';
+            bytes += static_cast<char>(digits);
+            bytes.append(standName, start, digits);
         }
-        
-        // Update coordinates to decimal format
-        coordinates = std::to_string(latDecimal) + ":" + std::to_string(lonDecimal) + ":" + radius;
-        return true;
-    }
-    
-    return false;
-}
-
-std::vector<std::pair<std::string, std::string>> parseStandName(const std::string& standName) {
-    std::vector<std::pair<std::string, std::string>> parts;
-    std::string current = "";
-    bool isNumber = false;
-    
-    for (char c : standName) {
-        bool currentIsDigit = std::isdigit(c);
-        
-        if (currentIsDigit != isNumber && !current.empty()) {
-            parts.push_back({current, isNumber ? "number" : "text"});
-            current = "";
+        else
+        {
+            while (i < standName.size() && !std::isdigit(static_cast<unsigned char>(standName[i])))
+                i++;
+            bytes += '\x02';
+            bytes.append(standName, start, i - start);
+            bytes += '\0';
         }
-        
-        current += c;
-        isNumber = currentIsDigit;
     }
-    
-    if (!current.empty()) {
-        parts.push_back({current, isNumber ? "number" : "text"});
-    }
-    
-    return parts;
+    // Fewer parts sort first: the end marker is below both run tags
+    bytes += '\0';
+    bytes += standName;
+    return key;
 }
 
 bool naturalSort(const std::string& a, const std::string& b) {
-    auto partsA = parseStandName(a);
-    auto partsB = parseStandName(b);
-    
-    size_t minSize = std::min(partsA.size(), partsB.size());
-    
-    for (size_t i = 0; i < minSize; ++i) {
-        const auto& partA = partsA[i];
-        const auto& partB = partsB[i];
-        
-        // If both are numbers, compare numerically
-        if (partA.second == "number" && partB.second == "number") {
-            int numA = std::stoi(partA.first);
-            int numB = std::stoi(partB.first);
-            if (numA != numB) {
-                return numA < numB;
-            }
-        }
-        // If both are text, compare lexicographically
-        else if (partA.second == "text" && partB.second == "text") {
-            if (partA.first != partB.first) {
-                return partA.first < partB.first;
-            }
+    return naturalKey(a) < naturalKey(b);
+}
+
+namespace
+{
+    // Mask bit of every letter of a set, 0 for any other byte
+    struct LetterTable
+    {
+        uint8_t bits[256];
+    };
+
+    constexpr LetterTable makeLetterTable(const char *letters)
+    {
+        LetterTable table{};
+        for (int i = 0; letters[i]; i++)
+            table.bits[static_cast<unsigned char>(letters[i])] = static_cast<uint8_t>(1u << i);
+        return table;
+    }
+
+    constexpr char codeLetters[] = "ABCDEF";
+    constexpr char useLetters[] = "ACHMP";
+    constexpr LetterTable codeTable = makeLetterTable(codeLetters);
+    constexpr LetterTable useTable = makeLetterTable(useLetters);
+    static_assert(codeTable.bits['F'] == 0x20 && codeTable.bits[','] == 0, "code letters map to bits 0..5");
+    static_assert(useTable.bits['P'] == 0x10 && useTable.bits['B'] == 0, "use letters map to bits 0..4");
+
+    // Non-empty and made only of letters of the set
+    bool lettersValid(const LetterTable &table, const std::string &text)
+    {
+        if (text.empty())
+            return false;
+        for (char c : text)
+        {
+            if (!table.bits[static_cast<unsigned char>(c)])
+                return false;
         }
-        // If types differ, numbers come before text
-        else {
-            return partA.second == "number" && partB.second == "text";
+        return true;
+    }
+
+    // Other characters are ignored
+    uint8_t lettersMask(const LetterTable &table, const std::string &text)
+    {
+        uint8_t mask = 0;
+        for (char c : text)
+            mask |= table.bits[static_cast<unsigned char>(c)];
+        return mask;
+    }
+
+    std::string lettersString(const char *letters, uint8_t mask)
+    {
+        std::string text;
+        for (int i = 0; letters[i]; i++)
+        {
+            if (mask & (1u << i))
+                text += letters[i];
         }
+        return text;
     }
-    
-    // If all compared parts are equal, shorter string comes first
-    return partsA.size() < partsB.size();
 }
 
 bool useIsValid(const std::string &use)
 {
-    std::regex validUseRegex(R"(^[A,C,H,M,P]+$)");
-    return std::regex_match(use, validUseRegex);
+    return lettersValid(useTable, use);
 }
 
 bool codeIsValid(const std::string &code)
 {
-    std::regex validCodeRegex(R"(^[A,B,C,D,E,F]+$)");
-    return std::regex_match(code, validCodeRegex);
+    return lettersValid(codeTable, code);
+}
+
+uint8_t codeMask(const std::string &code)
+{
+    return lettersMask(codeTable, code);
+}
+
+std::string codeString(uint8_t mask)
+{
+    return lettersString(codeLetters, mask);
+}
+
+uint8_t useMask(const std::string &use)
+{
+    return lettersMask(useTable, use);
+}
+
+std::string useString(uint8_t mask)
+{
+    return lettersString(useLetters, mask);
+}
+
+bool parseCoordinates(const std::string &coordinates, Coordinates &out, bool radius)
+{
+    // Stored values were validated when entered, so any radius is accepted here
+    CoordinateParse parse = scanCoordinates(coordinates, radius, 0);
+    if (parse.ok)
+        out = parse.coordinates;
+    return parse.ok;
+}
+
+std::string formatNumber(double value)
+{
+    std::string out;
+    appendNumber(out, value);
+    return out;
+}
+
+// Writes value as appendNumber does and returns its length
+static size_t numberChars(char (&buffer)[32], double value)
+{
+    // 15 significant digits round-trip any decimal the user typed, %g drops trailing zeros.
+    // to_chars gives the same text as %.15g without the locale lookup.
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+    return static_cast<size_t>(std::to_chars(buffer, buffer + sizeof(buffer), value, std::chars_format::general, 15).ptr - buffer);
+#else
+    return static_cast<size_t>(std::snprintf(buffer, sizeof(buffer), "%.15g", value));
+#endif
+}
+
+void appendNumber(std::string &out, double value)
+{
+    char buffer[32];
+    out.append(buffer, numberChars(buffer, value));
+}
+
+void appendInteger(std::string &out, long long value)
+{
+    char buffer[24];
+    out.append(buffer, std::to_chars(buffer, buffer + sizeof(buffer), value).ptr);
+}
+
+bool formatsAs(const Coordinates &coordinates, std::string_view text)
+{
+    char buffer[32];
+    auto number = [&](double value)
+    {
+        size_t size = numberChars(buffer, value);
+        if (text.substr(0, size) != std::string_view(buffer, size))
+            return false;
+        text.remove_prefix(size);
+        return true;
+    };
+    auto colon = [&]()
+    {
+        if (text.empty() || text.front() != ':')
+            return false;
+        text.remove_prefix(1);
+        return true;
+    };
+    if (!number(coordinates.lat) || !colon() || !number(coordinates.lon) || !colon())
+        return false;
+    return (!coordinates.hasRadius || number(coordinates.radius)) && text.empty();
+}
+
+std::string formatCoordinates(const Coordinates &coordinates)
+{
+    std::string out = formatNumber(coordinates.lat) + ":" + formatNumber(coordinates.lon);
+    if (coordinates.hasRadius)
+        out += ":" + formatNumber(coordinates.radius);
+    else
+        out += ":";
+    return out;
 }
@@ -1,5 +1,7 @@
 #pragma once
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <nlohmann/json.hpp>
 
@@ -31,12 +33,75 @@
 #define REVERSED "\033[7m"
 
 
+// Stand position in decimal degrees, radius in meters
+struct Coordinates
+{
+    double lat = 0;
+    double lon = 0;
+    double radius = 0;
+    bool hasRadius = false;
+};
+
+// Radius used for stands that do not set one, in meters
+constexpr double DEFAULT_RADIUS = 20;
+// Smallest radius accepted when coordinates are entered, in meters
+constexpr double MIN_RADIUS = 9;
+
+// Result of parseCoordinateText: the position, or the offset and reason of the first error
+struct CoordinateParse
+{
+    bool ok = false;
+    bool dms = false; // at least one axis was given as degrees/minutes/seconds
+    Coordinates coordinates;
+    size_t errorPos = 0;
+    const char *error = nullptr;
+};
+
+// Code letters A..F and use letters A, C, H, M, P are stored as one bit per letter
+constexpr uint8_t CODE_ALL = 0x3F;
+constexpr uint8_t USE_ALL = 0x1F;
+
+// Natural-order sort key of a stand name, built once and compared bytewise.
+// Digit runs are stored as 0x01, digit count, digits (leading zeros stripped) so they
+// compare by value; text runs as 0x02, bytes, 0x00. The raw name follows a 0x00 end
+// marker so that names like "A01" and "A1" still get a strict order.
+struct NaturalKey
+{
+    std::string bytes;
+
+    bool operator<(const NaturalKey &other) const { return bytes < other.bytes; }
+    bool operator==(const NaturalKey &other) const { return bytes == other.bytes; }
+    bool operator!=(const NaturalKey &other) const { return bytes != other.bytes; }
+};
+
 std::vector<std::string> splitString(const std::string &str);
 std::vector<std::string> splitRemark(const std::string &str);
 std::string getExecutableDir();
 std::string getBaseDir();
+// Single pass over lat:lon:radius in decimal (43.666359:7.216941:20) or DMS
+// (N043.37.40.861:E001.22.36.064:25) form, optionally prefixed by "COORD:". With radius
+// the third field must be present but may be empty, without it it is optional.
+CoordinateParse parseCoordinateText(std::string_view text, bool radius = true);
+// Single fields of parseCoordinateText for callers that split lines themselves: an axis
+// in either form, or an unsigned decimal number. The whole text must be consumed,
+// ranges are not checked.
+bool parseCoordinateAxis(std::string_view text, bool latitude, double &value);
+bool parseCoordinateNumber(std::string_view text, double &value);
+// Validates like parseCoordinateText and rewrites the text to the decimal form
 bool isCoordinatesValid(std::string &coordinates, bool radius = true);
 bool useIsValid(const std::string &use);
 bool codeIsValid(const std::string &code);
-std::vector<std::pair<std::string, std::string>> parseStandName(const std::string& standName);
+uint8_t codeMask(const std::string &code);
+std::string codeString(uint8_t mask);
+uint8_t useMask(const std::string &use);
+std::string useString(uint8_t mask);
+bool parseCoordinates(const std::string &coordinates, Coordinates &out, bool radius = true);
+std::string formatNumber(double value);
+// Append forms for bulk output, no temporary string per number
+void appendNumber(std::string &out, double value);
+void appendInteger(std::string &out, long long value);
+std::string formatCoordinates(const Coordinates &coordinates);
+// Whether formatCoordinates gives back text, without building the string
+bool formatsAs(const Coordinates &coordinates, std::string_view text);
+NaturalKey naturalKey(const std::string &standName);
 bool naturalSort(const std::string& a, const std::string& b);